@@ -0,0 +1,341 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "elorank-daemon.h"
+#include "pberr.h"
+#include "pbmath.h"
+
+// Parameters of the load
+typedef struct ELOLoadParam {
+  // Path of the socket of the daemon
+  const char* _path;
+  // Number of entities, ids are drawn in [0, _nbEntity[
+  uint32_t _nbEntity;
+  // Number of requests per client
+  int _nbRequest;
+  // Maximum number of requests sent and not yet answered per client
+  int _pipeline;
+  // Number of entities per update
+  int _matchSize;
+  // Ratio of queries among requests, in [0, 1]
+  float _query;
+} ELOLoadParam;
+
+// State of one client
+typedef struct ELOLoadClient {
+  // Parameters of the load
+  const ELOLoadParam* _param;
+  // Seed of the random generator
+  uint64_t _rnd;
+  // Time of sending, then latency in seconds, of each request
+  double* _latency;
+  // Number of responses with an error status
+  int _nbError;
+  // Flag raised if the connection failed
+  bool _failed;
+} ELOLoadClient;
+
+// Get the current time in seconds
+static double ELOLoadGetTime(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+// Get a random number from the generator of the client 'that'
+// (splitmix64)
+static uint64_t ELOLoadRnd(ELOLoadClient* const that) {
+  uint64_t z = (that->_rnd += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// Append the request 'reqId' drawn randomly by 'that' to 'buf'
+// Return the size of the request
+static size_t ELOLoadMakeRequest(ELOLoadClient* const that,
+  const uint32_t reqId, char* const buf) {
+  const ELOLoadParam* param = that->_param;
+  ELODaemonHeader header;
+  memset(&header, 0, sizeof(ELODaemonHeader));
+  header._reqId = reqId;
+  char* payload = buf + sizeof(ELODaemonHeader);
+  double r = (double)(ELOLoadRnd(that) >> 11) * 0x1.0p-53;
+  if (r < param->_query && ELOLoadRnd(that) % 16 == 0) {
+    // Top of the leaderboard
+    ELODaemonRange range = {._first = 0, ._nb = 10};
+    header._type = ELODaemonTypeLeaderboard;
+    header._size = sizeof(ELODaemonRange);
+    memcpy(payload, &range, sizeof(ELODaemonRange));
+  } else if (r < param->_query) {
+    // Rank and ELO of one entity
+    uint32_t id = ELOLoadRnd(that) % param->_nbEntity;
+    header._type = ELODaemonTypeGetEntity;
+    header._size = sizeof(uint32_t);
+    memcpy(payload, &id, sizeof(uint32_t));
+  } else {
+    // Result of a match between distinct random entities
+    ELODaemonResult res[ELODAEMON_MAXMATCHSIZE];
+    for (int iRes = 0; iRes < param->_matchSize; ++iRes) {
+      bool flagDup = true;
+      while (flagDup) {
+        res[iRes]._id = ELOLoadRnd(that) % param->_nbEntity;
+        flagDup = false;
+        for (int jRes = iRes; jRes-- && !flagDup;)
+          flagDup = (res[jRes]._id == res[iRes]._id);
+      }
+      res[iRes]._score = (float)(param->_matchSize - iRes);
+    }
+    header._type = ELODaemonTypeUpdate;
+    header._size = sizeof(ELODaemonResult) * param->_matchSize;
+    memcpy(payload, res, header._size);
+  }
+  memcpy(buf, &header, sizeof(ELODaemonHeader));
+  return sizeof(ELODaemonHeader) + header._size;
+}
+
+// Main function of the threads running a client
+static void* ELOLoadRun(void* arg) {
+  ELOLoadClient* that = arg;
+  const ELOLoadParam* param = that->_param;
+  // Connect to the daemon
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, param->_path, sizeof(addr.sun_path) - 1);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+    perror(param->_path);
+    if (fd >= 0)
+      close(fd);
+    that->_failed = true;
+    return NULL;
+  }
+  // The socket is non blocking and the responses are read while the
+  // requests are sent, else with a pipeline larger than the buffers of
+  // the socket the client would block on a write while the daemon, 
+  // which stops reading the requests of a client whose responses are 
+  // not read, would block too
+  if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0) {
+    perror(param->_path);
+    close(fd);
+    that->_failed = true;
+    return NULL;
+  }
+  size_t maxReq = sizeof(ELODaemonHeader) +
+    sizeof(ELODaemonResult) * ELODAEMON_MAXMATCHSIZE;
+  char* out = PBErrMalloc(ELORankErr, maxReq * param->_pipeline);
+  size_t sizeOut = 0;
+  size_t offsetOut = 0;
+  size_t capIn = 65536;
+  char* in = PBErrMalloc(ELORankErr, capIn);
+  size_t sizeIn = 0;
+  int nbSent = 0;
+  int nbRecv = 0;
+  while (nbRecv < param->_nbRequest && !that->_failed) {
+    // Once the previous requests are written, prepare new requests up
+    // to the depth of the pipeline
+    if (offsetOut == sizeOut) {
+      sizeOut = 0;
+      offsetOut = 0;
+      int firstSent = nbSent;
+      while (nbSent < param->_nbRequest &&
+        nbSent - nbRecv < param->_pipeline) {
+        sizeOut += ELOLoadMakeRequest(that, nbSent, out + sizeOut);
+        ++nbSent;
+      }
+      double t = ELOLoadGetTime();
+      for (int iReq = firstSent; iReq < nbSent; ++iReq)
+        that->_latency[iReq] = t;
+    }
+    // Wait until the socket can be written, if there are requests to
+    // write, or read
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+    if (offsetOut < sizeOut)
+      pfd.events |= POLLOUT;
+    if (poll(&pfd, 1, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      that->_failed = true;
+      break;
+    }
+    // Write as much of the requests as possible
+    if (pfd.revents & POLLOUT) {
+      ssize_t nb = write(fd, out + offsetOut, sizeOut - offsetOut);
+      if (nb < 0 && errno != EINTR && errno != EAGAIN &&
+        errno != EWOULDBLOCK) {
+        that->_failed = true;
+        break;
+      }
+      if (nb > 0)
+        offsetOut += nb;
+    }
+    // Read the available responses
+    if (pfd.revents & (POLLIN | POLLHUP | POLLERR)) {
+      if (sizeIn == capIn) {
+        capIn *= 2;
+        in = realloc(in, capIn);
+        if (in == NULL) {
+          ELORankErr->_type = PBErrTypeMallocFailed;
+          sprintf(ELORankErr->_msg, "realloc of %zu bytes failed", capIn);
+          PBErrCatch(ELORankErr);
+        }
+      }
+      ssize_t nb = read(fd, in + sizeIn, capIn - sizeIn);
+      if (nb < 0 && (errno == EINTR || errno == EAGAIN ||
+        errno == EWOULDBLOCK))
+        continue;
+      if (nb <= 0) {
+        that->_failed = true;
+        break;
+      }
+      sizeIn += nb;
+      double t = ELOLoadGetTime();
+      size_t offset = 0;
+      ELODaemonHeader header;
+      while (sizeIn - offset >= sizeof(ELODaemonHeader)) {
+        memcpy(&header, in + offset, sizeof(ELODaemonHeader));
+        if (sizeIn - offset - sizeof(ELODaemonHeader) < header._size)
+          break;
+        if (header._reqId < (uint32_t)nbSent)
+          that->_latency[header._reqId] =
+            t - that->_latency[header._reqId];
+        if (header._status != ELODaemonStatusOK)
+          ++(that->_nbError);
+        offset += sizeof(ELODaemonHeader) + header._size;
+        ++nbRecv;
+      }
+      sizeIn -= offset;
+      memmove(in, in + offset, sizeIn);
+    }
+  }
+  // Free memory
+  free(in);
+  free(out);
+  close(fd);
+  return NULL;
+}
+
+// Compare two doubles for qsort
+static int ELOLoadCmp(const void* a, const void* b) {
+  double x = *(const double*)a;
+  double y = *(const double*)b;
+  return (x > y) - (x < y);
+}
+
+// Print the usage of the command
+void PrintUsage(void) {
+  printf("eloload [-help] [-socket <path>] [-nbEntity <n>] "
+    "[-nbRequest <n>] [-pipeline <n>] [-matchSize <n>] [-query <x>] "
+    "[-nbClient <n>] [-seed <n>]\n");
+}
+
+int main(int argc, char** argv) {
+  // Default parameters
+  ELOLoadParam param = {
+    ._path = ELODAEMON_SOCKET, ._nbEntity = 10000, ._nbRequest = 100000,
+    ._pipeline = 64, ._matchSize = 2, ._query = 0.5};
+  int nbClient = 1;
+  unsigned long seed = 0;
+  // Decode the arguments
+  for (int iArg = 1; iArg < argc; ++iArg) {
+    if (strcmp(argv[iArg], "-help") == 0) {
+      PrintUsage();
+      return 0;
+    } else if (iArg + 1 >= argc) {
+      PrintUsage();
+      return 1;
+    } else if (strcmp(argv[iArg], "-socket") == 0) {
+      param._path = argv[++iArg];
+    } else if (strcmp(argv[iArg], "-nbEntity") == 0) {
+      param._nbEntity = strtoul(argv[++iArg], NULL, 10);
+    } else if (strcmp(argv[iArg], "-nbRequest") == 0) {
+      param._nbRequest = atoi(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-pipeline") == 0) {
+      param._pipeline = atoi(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-matchSize") == 0) {
+      param._matchSize = atoi(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-query") == 0) {
+      param._query = atof(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-nbClient") == 0) {
+      nbClient = atoi(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-seed") == 0) {
+      seed = strtoul(argv[++iArg], NULL, 10);
+    } else {
+      PrintUsage();
+      return 1;
+    }
+  }
+  if (nbClient < 1 || param._nbRequest < 1 || param._pipeline < 1 ||
+    param._matchSize < 2 || param._matchSize > ELODAEMON_MAXMATCHSIZE ||
+    param._nbEntity < (uint32_t)param._matchSize) {
+    PrintUsage();
+    return 1;
+  }
+  // Run the clients
+  ELOLoadClient* clients =
+    PBErrMalloc(ELORankErr, sizeof(ELOLoadClient) * nbClient);
+  pthread_t* threads =
+    PBErrMalloc(ELORankErr, sizeof(pthread_t) * nbClient);
+  for (int iClient = 0; iClient < nbClient; ++iClient) {
+    clients[iClient]._param = &param;
+    clients[iClient]._rnd = seed + iClient;
+    clients[iClient]._latency =
+      PBErrMalloc(ELORankErr, sizeof(double) * param._nbRequest);
+    clients[iClient]._nbError = 0;
+    clients[iClient]._failed = false;
+  }
+  double start = ELOLoadGetTime();
+  for (int iClient = 0; iClient < nbClient; ++iClient)
+    pthread_create(threads + iClient, NULL, ELOLoadRun, clients + iClient);
+  for (int iClient = 0; iClient < nbClient; ++iClient)
+    pthread_join(threads[iClient], NULL);
+  double stop = ELOLoadGetTime();
+  // Display the results
+  int ret = 0;
+  long nbReq = (long)nbClient * param._nbRequest;
+  double* latencies = PBErrMalloc(ELORankErr, sizeof(double) * nbReq);
+  int nbError = 0;
+  for (int iClient = 0; iClient < nbClient; ++iClient) {
+    if (clients[iClient]._failed)
+      ret = 1;
+    nbError += clients[iClient]._nbError;
+    memcpy(latencies + (long)iClient * param._nbRequest,
+      clients[iClient]._latency, sizeof(double) * param._nbRequest);
+  }
+  if (ret == 0) {
+    qsort(latencies, nbReq, sizeof(double), ELOLoadCmp);
+    double sum = 0.0;
+    for (long iReq = nbReq; iReq--;)
+      sum += latencies[iReq];
+    printf("requests: %ld (%d clients, pipeline %d)\n", nbReq, nbClient,
+      param._pipeline);
+    printf("errors: %d\n", nbError);
+    printf("time: %fs\n", stop - start);
+    printf("throughput: %f req/s\n", (double)nbReq / (stop - start));
+    printf("latency mean: %fms p50: %fms p99: %fms max: %fms\n",
+      sum / (double)nbReq * 1000.0, latencies[nbReq / 2] * 1000.0,
+      latencies[nbReq * 99 / 100] * 1000.0,
+      latencies[nbReq - 1] * 1000.0);
+  } else {
+    fprintf(stderr, "connection to the daemon failed\n");
+  }
+  // Free memory
+  free(latencies);
+  for (int iClient = 0; iClient < nbClient; ++iClient)
+    free(clients[iClient]._latency);
+  free(threads);
+  free(clients);
+  // Return success code
+  return ret;
+}
@@ -0,0 +1,88 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include "elorank.h"
+#include "elorank-map.h"
+#include "pberr.h"
+#include "pbmath.h"
+
+// Print the usage of the command
+void PrintUsage(void) {
+  printf("elomapbench [-help] [-path <file>] [-min <n>] [-max <n>]\n");
+}
+
+// Return the time in seconds elapsed since 'start'
+double GetElapsed(const struct timeval* const start) {
+  struct timeval stop;
+  gettimeofday(&stop, NULL);
+  return (double)(stop.tv_sec - start->tv_sec) +
+    (double)(stop.tv_usec - start->tv_usec) / 1000000.0;
+}
+
+int main(int argc, char** argv) {
+  // Default parameters
+  const char* path = "./elomapbench.bin";
+  unsigned long nbMin = 20000;
+  unsigned long nbMax = 1280000;
+  // Decode the arguments
+  for (int iArg = 1; iArg < argc; ++iArg) {
+    if (strcmp(argv[iArg], "-help") == 0) {
+      PrintUsage();
+      return 0;
+    } else if (iArg + 1 >= argc) {
+      PrintUsage();
+      return 1;
+    } else if (strcmp(argv[iArg], "-path") == 0) {
+      path = argv[++iArg];
+    } else if (strcmp(argv[iArg], "-min") == 0) {
+      nbMin = strtoul(argv[++iArg], NULL, 10);
+    } else if (strcmp(argv[iArg], "-max") == 0) {
+      nbMax = strtoul(argv[++iArg], NULL, 10);
+    } else {
+      PrintUsage();
+      return 1;
+    }
+  }
+  if (nbMin < 1 || nbMax < nbMin) {
+    PrintUsage();
+    return 1;
+  }
+  // For each number of entities, doubling from nbMin to nbMax, add
+  // the entities in bulk (they all have the start ELO, hence are all in
+  // the same bucket of the rank index) and query the rank of each of
+  // them and the entity at each rank
+  printf("nbEntity add(s) getRank(s) getRanked(s)\n");
+  for (unsigned long nb = nbMin; nb <= nbMax; nb *= 2) {
+    ELORankMap* map = ELORankMapCreate(path, nb, -1000.0, 1000.0,
+      ELORANKMAP_RESOLUTION);
+    if (map == NULL) {
+      fprintf(stderr, "Couldn't create %s\n", path);
+      return 1;
+    }
+    struct timeval start;
+    gettimeofday(&start, NULL);
+    for (unsigned long id = 0; id < nb; ++id)
+      (void)ELORankMapAdd(map, id);
+    double timeAdd = GetElapsed(&start);
+    gettimeofday(&start, NULL);
+    unsigned long sum = 0;
+    for (unsigned long id = 0; id < nb; ++id)
+      sum += ELORankMapGetRank(map, id);
+    double timeRank = GetElapsed(&start);
+    gettimeofday(&start, NULL);
+    for (unsigned long rank = 0; rank < nb; ++rank)
+      sum -= ELORankMapGetRanked(map, rank);
+    double timeRanked = GetElapsed(&start);
+    // The ranks and the ids are both a permutation of [0, nb[
+    if (sum != 0) {
+      fprintf(stderr, "Inconsistent ranks for %lu entities\n", nb);
+      return 1;
+    }
+    printf("%lu %f %f %f\n", nb, timeAdd, timeRank, timeRanked);
+    ELORankMapFree(&map);
+    remove(path);
+  }
+  // Return success code
+  return 0;
+}
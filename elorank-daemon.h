@@ -0,0 +1,111 @@
+// ============ ELORANK-DAEMON.H ================
+
+#ifndef ELORANK_DAEMON_H
+#define ELORANK_DAEMON_H
+
+// ================= Include =================
+
+#include <stdint.h>
+
+// ================= Define ==================
+
+// Default path of the Unix socket of the daemon
+#define ELODAEMON_SOCKET "/tmp/elorankd.sock"
+// Default maximum number of entities (ids are in [0, max[)
+#define ELODAEMON_NBMAXENTITY 1048576
+// Maximum size of the payload of a request, in bytes
+#define ELODAEMON_MAXPAYLOAD 65536
+// Maximum number of entities in one update
+#define ELODAEMON_MAXMATCHSIZE 64
+// Size of the buffer of pending responses of a client above which the
+// daemon stops reading its requests until it has read the responses
+#define ELODAEMON_MAXPENDING 1048576
+
+// ================= Data structure ===================
+
+// The protocol is a stream of binary messages over a Unix domain socket
+// in the native byte order of the host (the socket is local). Each
+// message is an ELODaemonHeader followed by _size bytes of payload.
+// A client can send any number of requests without waiting for their
+// responses (pipelining), the daemon answers each of them exactly once
+// and in the order of the requests of this client. Updates are queued
+// and applied in batch, a query sees at least all the updates sent
+// before it by the same client.
+
+// Type of the messages
+typedef enum ELODaemonType {
+  // Update the ranks with the result of a match
+  // Request payload: array of ELODaemonResult (2 to
+  // ELODAEMON_MAXMATCHSIZE elements, distinct ids)
+  // Response payload: none
+  // Entities unknown to the daemon are added at the start ELO
+  ELODaemonTypeUpdate,
+  // Get the rank and ELO of entities
+  // Request payload: array of uint32_t ids
+  // Response payload: one ELODaemonEntity per id, with _rank equal to
+  // -1 for unknown entities
+  ELODaemonTypeGetEntity,
+  // Get a range of the leaderboard
+  // Request payload: ELODaemonRange
+  // Response payload: array of ELODaemonEntity in increasing rank,
+  // possibly shorter than requested at the end of the leaderboard
+  ELODaemonTypeLeaderboard,
+  // Get the number of entities
+  // Request payload: none
+  // Response payload: uint32_t
+  ELODaemonTypeGetNb
+} ELODaemonType;
+
+// Status of the responses
+typedef enum ELODaemonStatus {
+  ELODaemonStatusOK,
+  // The type of the request is unknown
+  ELODaemonStatusUnknownType,
+  // The payload of the request is invalid
+  ELODaemonStatusInvalidArg
+} ELODaemonStatus;
+
+// Header of requests and responses
+typedef struct ELODaemonHeader {
+  // Size of the payload following the header, in bytes
+  uint32_t _size;
+  // Identifier of the request given by the client, copied in the
+  // response
+  uint32_t _reqId;
+  // Type of the message (ELODaemonType)
+  uint8_t _type;
+  // Status of the response (ELODaemonStatus), unused in requests
+  uint8_t _status;
+  // Unused
+  uint16_t _reserved;
+} ELODaemonHeader;
+
+// Score of one entity in an update
+typedef struct ELODaemonResult {
+  // Id of the entity
+  uint32_t _id;
+  // Score of the entity (higher is better, equal means tie)
+  float _score;
+} ELODaemonResult;
+
+// Range of the leaderboard
+typedef struct ELODaemonRange {
+  // Rank of the first entity
+  uint32_t _first;
+  // Number of entities
+  uint32_t _nb;
+} ELODaemonRange;
+
+// Rank and ELO of an entity
+typedef struct ELODaemonEntity {
+  // Id of the entity
+  uint32_t _id;
+  // Rank of the entity (starts at 0, -1 if the entity is unknown)
+  int32_t _rank;
+  // Current ELO
+  float _elo;
+  // Current soft ELO
+  float _softElo;
+} ELODaemonEntity;
+
+#endif
@@ -2,6 +2,23 @@
 
 // ================ Functions implementation ====================
 
+// Get the ELORank from which 'that' has been forked, or NULL if 'that'
+// is not a fork
+#if BUILDMODE != 0
+static inline
+#endif
+const ELORank* ELORankGetParent(const ELORank* const that) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_parent;
+}
+
 // Set the K coefficient of 'that' to 'k' 
 #if BUILDMODE != 0
 static inline
@@ -47,6 +64,59 @@ int ELORankGetNb(const ELORank* const that) {
     PBErrCatch(ELORankErr);
   }
 #endif
-  return GSetNbElem(&(that->_set));
+  // The entities of a fork are the ones of the ELORank at the root of 
+  // the forks
+  const ELORank* root = that;
+  while (root->_parent != NULL)
+    root = root->_parent;
+  return GSetNbElem(&(root->_set));
+}
+
+// Get the decay rate of 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+float ELORankGetDecay(const ELORank* const that) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_decay;
 }
 
+// Get the current time of 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+long ELORankGetTime(const ELORank* const that) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_time;
+}
+
+// Get the number of results applied to 'that' since its creation
+// (including the ones applied to its parents before the fork)
+#if BUILDMODE != 0
+static inline
+#endif
+long ELORankGetNbMatch(const ELORank* const that) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_nbMatch;
+}
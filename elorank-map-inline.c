@@ -0,0 +1,68 @@
+// ============ ELORANK-MAP-INLINE.C ================
+
+// ================ Functions implementation ====================
+
+// Set the K coefficient of 'that' to 'k'
+#if BUILDMODE != 0
+static inline
+#endif
+void ELORankMapSetK(ELORankMap* const that, const float k) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  that->_header->_k = k;
+}
+
+// Get the K coefficient of 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+float ELORankMapGetK(const ELORankMap* const that) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_header->_k;
+}
+
+// Get the number of entity in 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned long ELORankMapGetNb(const ELORankMap* const that) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_header->_nbEntity;
+}
+
+// Get the maximum number of entity in 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned long ELORankMapGetCapacity(const ELORankMap* const that) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_header->_capacity;
+}
+
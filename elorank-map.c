@@ -0,0 +1,856 @@
+// ============ ELORANK-MAP.C ================
+
+// ================= Include =================
+
+#include "elorank-map.h"
+#if BUILDMODE == 0
+#include "elorank-map-inline.c"
+#endif
+
+// ================ Functions declaration ====================
+
+// Get the size of the file for the ELORankMap described by 'header'
+static size_t ELORankMapGetFileSize(const ELORankMapHeader* const header);
+
+// Map the file 'fd' of size 'size' and return the new ELORankMap
+// Return NULL if the file couldn't be mapped
+static ELORankMap* ELORankMapCreateFromFd(const int fd,
+  const size_t size);
+
+// Return the index in the hash table of the entity 'id' if it's in
+// 'that', or of the empty entry where it would be added else
+static unsigned long ELORankMapGetHashPos(const ELORankMap* const that,
+  const unsigned long id);
+
+// Return the slot of the entity 'id' in 'that', or UINT_MAX if 'that'
+// doesn't contain 'id'
+static unsigned int ELORankMapGetSlot(const ELORankMap* const that,
+  const unsigned long id);
+
+// Remove the entry at index 'pos' in the hash table of 'that'
+static void ELORankMapRemoveHash(ELORankMap* const that,
+  unsigned long pos);
+
+// Return the bucket of the rank index for the ELO 'elo'
+static unsigned long ELORankMapGetBucket(const ELORankMap* const that,
+  const float elo);
+
+// Add 'delta' to the number of entities in the bucket 'bucket'
+static void ELORankMapFenwickAdd(ELORankMap* const that,
+  const unsigned long bucket, const int delta);
+
+// Return the number of entities in the buckets 0 to 'bucket'
+static unsigned long ELORankMapFenwickGetPrefix(
+  const ELORankMap* const that, const unsigned long bucket);
+
+// Return the lowest bucket such as the number of entities in the
+// buckets 0 to this bucket is greater than 'nb'
+static unsigned long ELORankMapFenwickSearch(
+  const ELORankMap* const that, unsigned long nb);
+
+// Return true if the record 'a' is ranked before the record 'b'
+static bool ELORankMapIsBefore(const ELORankMapRecord* const a,
+  const ELORankMapRecord* const b);
+
+// Return the priority in the treap of the record 'rec'
+static unsigned long ELORankMapGetPriority(
+  const ELORankMapRecord* const rec);
+
+// Return the number of records in the tree 'tree' (slot + 1 of its
+// root, 0 if empty)
+static unsigned int ELORankMapGetNbTree(const ELORankMap* const that,
+  const unsigned int tree);
+
+// Split the tree 'tree' into the trees 'before' and 'after' of the 
+// records ranked respectively before and after the record 'rec'
+static void ELORankMapSplitTree(ELORankMap* const that,
+  const unsigned int tree, const ELORankMapRecord* const rec,
+  unsigned int* const before, unsigned int* const after);
+
+// Merge the trees 'before' and 'after', all the records of 'before'
+// being ranked before the ones of 'after'
+// Return the merged tree
+static unsigned int ELORankMapMergeTree(ELORankMap* const that,
+  const unsigned int before, const unsigned int after);
+
+// Insert the record at 'node - 1' in the tree 'tree'
+// Return the new tree
+static unsigned int ELORankMapInsertTree(ELORankMap* const that,
+  const unsigned int tree, const unsigned int node);
+
+// Remove the record at 'node - 1' from the tree 'tree'
+// Return the new tree
+static unsigned int ELORankMapRemoveTree(ELORankMap* const that,
+  const unsigned int tree, const unsigned int node);
+
+// Insert the record at 'slot' in its bucket according to its ELO
+static void ELORankMapLink(ELORankMap* const that,
+  const unsigned int slot);
+
+// Remove the record at 'slot' from its bucket
+static void ELORankMapUnlink(ELORankMap* const that,
+  const unsigned int slot);
+
+// ================ Functions implementation ====================
+
+// Get the size of the file for the ELORankMap described by 'header'
+static size_t ELORankMapGetFileSize(const ELORankMapHeader* const header) {
+  return ELORANKMAP_HEADERSIZE +
+    sizeof(ELORankMapRecord) * header->_capacity +
+    sizeof(unsigned int) * header->_nbHash +
+    sizeof(unsigned int) * header->_nbBucket +
+    sizeof(unsigned int) * (header->_nbBucket + 1);
+}
+
+// Map the file 'fd' of size 'size' and return the new ELORankMap
+// Return NULL if the file couldn't be mapped
+static ELORankMap* ELORankMapCreateFromFd(const int fd,
+  const size_t size) {
+  // Map the file
+  void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED)
+    return NULL;
+  // Entities are accessed randomly, avoid useless read ahead
+  (void)madvise(map, size, MADV_RANDOM);
+  // Allocate memory
+  ELORankMap* that = PBErrMalloc(ELORankErr, sizeof(ELORankMap));
+  // Set the properties
+  that->_fd = fd;
+  that->_size = size;
+  that->_map = map;
+  that->_header = (ELORankMapHeader*)map;
+  that->_records =
+    (ELORankMapRecord*)((char*)map + ELORANKMAP_HEADERSIZE);
+  that->_hash =
+    (unsigned int*)(that->_records + that->_header->_capacity);
+  that->_roots = that->_hash + that->_header->_nbHash;
+  that->_fenwick = that->_roots + that->_header->_nbBucket;
+  // Return the new ELORankMap
+  return that;
+}
+
+// Create a new ELORankMap stored in the file at 'path' (overwritten if
+// it exists) for at most 'capacity' entities, with a rank index
+// covering [eloMin, eloMax] by intervals of 'resolution'
+// ELO outside of [eloMin, eloMax] are ranked in the first or last
+// interval
+// Return NULL if the file couldn't be created
+ELORankMap* ELORankMapCreate(const char* const path,
+  const unsigned long capacity, const float eloMin, const float eloMax,
+  const float resolution) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (path == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'path' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (capacity < 1 || capacity >= UINT_MAX) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'capacity' is invalid (1<=%lu<%u)",
+      capacity, UINT_MAX);
+    PBErrCatch(ELORankErr);
+  }
+  if (eloMax <= eloMin || resolution <= 0.0) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg,
+      "'eloMin', 'eloMax' or 'resolution' is invalid (%f<%f, %f>0.0)",
+      eloMin, eloMax, resolution);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Get the dimensions of the ELORankMap
+  ELORankMapHeader header;
+  memset(&header, 0, sizeof(ELORankMapHeader));
+  memcpy(header._magic, ELORANKMAP_MAGIC, sizeof(header._magic));
+  header._capacity = capacity;
+  header._nbEntity = 0;
+  header._nbLink = 0;
+  // The hash table is at most half full
+  header._nbHash = 1;
+  while (header._nbHash < 2 * capacity)
+    header._nbHash <<= 1;
+  header._nbBucket =
+    (unsigned long)ceil((eloMax - eloMin) / resolution) + 1;
+  header._eloMin = eloMin;
+  header._resolution = resolution;
+  header._k = ELORANK_K;
+  size_t size = ELORankMapGetFileSize(&header);
+  // Create the file, it's initially filled with null bytes which
+  // means empty hash table and rank index. The file is sparse, so
+  // disk space is used only as entities are added
+  int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1)
+    return NULL;
+  // Write the header
+  if (ftruncate(fd, size) == -1 ||
+    write(fd, &header, sizeof(ELORankMapHeader)) !=
+    sizeof(ELORankMapHeader)) {
+    close(fd);
+    return NULL;
+  }
+  // Map the file
+  ELORankMap* that = ELORankMapCreateFromFd(fd, size);
+  if (that == NULL)
+    close(fd);
+  // Return the new ELORankMap
+  return that;
+}
+
+// Open the ELORankMap stored in the file at 'path'
+// Return NULL if the file couldn't be opened or is not a valid
+// ELORankMap
+ELORankMap* ELORankMapOpen(const char* const path) {
+#if BUILDMODE == 0
+  // Check argument
+  if (path == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'path' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Open the file and read its header
+  int fd = open(path, O_RDWR);
+  if (fd == -1)
+    return NULL;
+  ELORankMapHeader header;
+  struct stat st;
+  if (read(fd, &header, sizeof(ELORankMapHeader)) !=
+    sizeof(ELORankMapHeader) ||
+    memcmp(header._magic, ELORANKMAP_MAGIC, sizeof(header._magic)) != 0 ||
+    fstat(fd, &st) == -1 ||
+    (size_t)st.st_size != ELORankMapGetFileSize(&header)) {
+    close(fd);
+    return NULL;
+  }
+  // Map the file
+  ELORankMap* that = ELORankMapCreateFromFd(fd, st.st_size);
+  if (that == NULL)
+    close(fd);
+  // Return the ELORankMap
+  return that;
+}
+
+// Flush the ELORankMap 'that' to its file
+void ELORankMapSync(const ELORankMap* const that) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  (void)msync(that->_map, that->_size, MS_SYNC);
+}
+
+// Free memory used by an ELORankMap, the file is kept
+void ELORankMapFree(ELORankMap** that) {
+  // Check the argument
+  if (that == NULL || *that == NULL) return;
+  // Unmap and close the file, modifications are written to the file
+  // by the operating system
+  munmap((*that)->_map, (*that)->_size);
+  close((*that)->_fd);
+  // Free memory
+  free(*that);
+  // Set the pointer to null
+  *that = NULL;
+}
+
+// Return the index in the hash table of the entity 'id' if it's in
+// 'that', or of the empty entry where it would be added else
+static unsigned long ELORankMapGetHashPos(const ELORankMap* const that,
+  const unsigned long id) {
+  unsigned long mask = that->_header->_nbHash - 1;
+  unsigned long h = id * 0x9E3779B97F4A7C15UL;
+  unsigned long pos = (h ^ (h >> 29)) & mask;
+  // Linear probing
+  while (that->_hash[pos] != 0 &&
+    that->_records[that->_hash[pos] - 1]._id != id)
+    pos = (pos + 1) & mask;
+  return pos;
+}
+
+// Return the slot of the entity 'id' in 'that', or UINT_MAX if 'that'
+// doesn't contain 'id'
+static unsigned int ELORankMapGetSlot(const ELORankMap* const that,
+  const unsigned long id) {
+  unsigned long pos = ELORankMapGetHashPos(that, id);
+  if (that->_hash[pos] == 0)
+    return UINT_MAX;
+  return that->_hash[pos] - 1;
+}
+
+// Remove the entry at index 'pos' in the hash table of 'that'
+// The following entries are shifted backward to keep the probing
+// sequences valid
+static void ELORankMapRemoveHash(ELORankMap* const that,
+  unsigned long pos) {
+  unsigned long mask = that->_header->_nbHash - 1;
+  that->_hash[pos] = 0;
+  unsigned long next = (pos + 1) & mask;
+  while (that->_hash[next] != 0) {
+    // Get the position where the entry at 'next' would be without
+    // collision
+    unsigned long h =
+      that->_records[that->_hash[next] - 1]._id * 0x9E3779B97F4A7C15UL;
+    unsigned long home = (h ^ (h >> 29)) & mask;
+    // If this position is not in ]pos, next], move the entry to the
+    // empty entry
+    bool inRange = (pos < next ?
+      (home > pos && home <= next) : (home > pos || home <= next));
+    if (!inRange) {
+      that->_hash[pos] = that->_hash[next];
+      that->_hash[next] = 0;
+      pos = next;
+    }
+    next = (next + 1) & mask;
+  }
+}
+
+// Return the bucket of the rank index for the ELO 'elo'
+static unsigned long ELORankMapGetBucket(const ELORankMap* const that,
+  const float elo) {
+  float b = floor((elo - that->_header->_eloMin) /
+    that->_header->_resolution);
+  if (b < 0.0)
+    return 0;
+  if (b >= (float)(that->_header->_nbBucket - 1))
+    return that->_header->_nbBucket - 1;
+  return (unsigned long)b;
+}
+
+// Add 'delta' to the number of entities in the bucket 'bucket'
+static void ELORankMapFenwickAdd(ELORankMap* const that,
+  const unsigned long bucket, const int delta) {
+  for (unsigned long i = bucket + 1; i <= that->_header->_nbBucket;
+    i += i & (~i + 1))
+    that->_fenwick[i] += (unsigned int)delta;
+}
+
+// Return the number of entities in the buckets 0 to 'bucket'
+static unsigned long ELORankMapFenwickGetPrefix(
+  const ELORankMap* const that, const unsigned long bucket) {
+  unsigned long nb = 0;
+  for (unsigned long i = bucket + 1; i > 0; i -= i & (~i + 1))
+    nb += that->_fenwick[i];
+  return nb;
+}
+
+// Return the lowest bucket such as the number of entities in the
+// buckets 0 to this bucket is greater than 'nb'
+static unsigned long ELORankMapFenwickSearch(
+  const ELORankMap* const that, unsigned long nb) {
+  unsigned long pos = 0;
+  unsigned long step = 1;
+  while ((step << 1) <= that->_header->_nbBucket)
+    step <<= 1;
+  for (; step > 0; step >>= 1) {
+    if (pos + step <= that->_header->_nbBucket &&
+      that->_fenwick[pos + step] <= nb) {
+      pos += step;
+      nb -= that->_fenwick[pos];
+    }
+  }
+  return pos;
+}
+
+// Return true if the record 'a' is ranked before the record 'b'
+// Records are ranked in decreasing ELO, then in increasing insertion 
+// number
+static bool ELORankMapIsBefore(const ELORankMapRecord* const a,
+  const ELORankMapRecord* const b) {
+  return (a->_elo > b->_elo || (a->_elo == b->_elo && a->_seq < b->_seq));
+}
+
+// Return the priority in the treap of the record 'rec'
+// The priority depends only on the identifier so it doesn't change
+// when the record is moved to another slot
+static unsigned long ELORankMapGetPriority(
+  const ELORankMapRecord* const rec) {
+  unsigned long z = rec->_id + 0x9E3779B97F4A7C15UL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+  return z ^ (z >> 31);
+}
+
+// Return the number of records in the tree 'tree' (slot + 1 of its
+// root, 0 if empty)
+static unsigned int ELORankMapGetNbTree(const ELORankMap* const that,
+  const unsigned int tree) {
+  return (tree == 0 ? 0 : that->_records[tree - 1]._nbTree);
+}
+
+// Split the tree 'tree' into the trees 'before' and 'after' of the 
+// records ranked respectively before and after the record 'rec'
+static void ELORankMapSplitTree(ELORankMap* const that,
+  const unsigned int tree, const ELORankMapRecord* const rec,
+  unsigned int* const before, unsigned int* const after) {
+  if (tree == 0) {
+    *before = 0;
+    *after = 0;
+    return;
+  }
+  ELORankMapRecord* root = that->_records + tree - 1;
+  if (ELORankMapIsBefore(root, rec)) {
+    ELORankMapSplitTree(that, root->_right, rec, &(root->_right), after);
+    *before = tree;
+  } else {
+    ELORankMapSplitTree(that, root->_left, rec, before, &(root->_left));
+    *after = tree;
+  }
+  root->_nbTree = 1 + ELORankMapGetNbTree(that, root->_left) +
+    ELORankMapGetNbTree(that, root->_right);
+}
+
+// Merge the trees 'before' and 'after', all the records of 'before'
+// being ranked before the ones of 'after'
+// Return the merged tree
+static unsigned int ELORankMapMergeTree(ELORankMap* const that,
+  const unsigned int before, const unsigned int after) {
+  if (before == 0)
+    return after;
+  if (after == 0)
+    return before;
+  ELORankMapRecord* recBefore = that->_records + before - 1;
+  ELORankMapRecord* recAfter = that->_records + after - 1;
+  if (ELORankMapGetPriority(recBefore) > 
+    ELORankMapGetPriority(recAfter)) {
+    recBefore->_nbTree += ELORankMapGetNbTree(that, after);
+    recBefore->_right = 
+      ELORankMapMergeTree(that, recBefore->_right, after);
+    return before;
+  } else {
+    recAfter->_nbTree += ELORankMapGetNbTree(that, before);
+    recAfter->_left = ELORankMapMergeTree(that, before, recAfter->_left);
+    return after;
+  }
+}
+
+// Insert the record at 'node - 1' in the tree 'tree'
+// Return the new tree
+static unsigned int ELORankMapInsertTree(ELORankMap* const that,
+  const unsigned int tree, const unsigned int node) {
+  ELORankMapRecord* rec = that->_records + node - 1;
+  // If the record has a higher priority than the root of the tree, 
+  // or the tree is empty, it becomes the root
+  if (tree == 0 || ELORankMapGetPriority(rec) > 
+    ELORankMapGetPriority(that->_records + tree - 1)) {
+    ELORankMapSplitTree(that, tree, rec, &(rec->_left), &(rec->_right));
+    rec->_nbTree = 1 + ELORankMapGetNbTree(that, rec->_left) +
+      ELORankMapGetNbTree(that, rec->_right);
+    return node;
+  }
+  // Else insert it in the left or right subtree
+  ELORankMapRecord* root = that->_records + tree - 1;
+  if (ELORankMapIsBefore(rec, root))
+    root->_left = ELORankMapInsertTree(that, root->_left, node);
+  else
+    root->_right = ELORankMapInsertTree(that, root->_right, node);
+  ++(root->_nbTree);
+  return tree;
+}
+
+// Remove the record at 'node - 1' from the tree 'tree'
+// Return the new tree
+static unsigned int ELORankMapRemoveTree(ELORankMap* const that,
+  const unsigned int tree, const unsigned int node) {
+  ELORankMapRecord* root = that->_records + tree - 1;
+  // If the record is the root, replace it with the merge of its 
+  // subtrees
+  if (tree == node)
+    return ELORankMapMergeTree(that, root->_left, root->_right);
+  // Else remove it from the left or right subtree
+  if (ELORankMapIsBefore(that->_records + node - 1, root))
+    root->_left = ELORankMapRemoveTree(that, root->_left, node);
+  else
+    root->_right = ELORankMapRemoveTree(that, root->_right, node);
+  --(root->_nbTree);
+  return tree;
+}
+
+// Insert the record at 'slot' in its bucket according to its ELO
+// The record is ranked after the records of equal ELO already in the
+// rank index
+static void ELORankMapLink(ELORankMap* const that,
+  const unsigned int slot) {
+  ELORankMapRecord* rec = that->_records + slot;
+  unsigned long bucket = ELORankMapGetBucket(that, rec->_elo);
+  rec->_seq = (that->_header->_nbLink)++;
+  that->_roots[bucket] = 
+    ELORankMapInsertTree(that, that->_roots[bucket], slot + 1);
+  // Update the number of entities in the bucket
+  ELORankMapFenwickAdd(that, bucket, 1);
+}
+
+// Remove the record at 'slot' from its bucket
+static void ELORankMapUnlink(ELORankMap* const that,
+  const unsigned int slot) {
+  ELORankMapRecord* rec = that->_records + slot;
+  unsigned long bucket = ELORankMapGetBucket(that, rec->_elo);
+  that->_roots[bucket] = 
+    ELORankMapRemoveTree(that, that->_roots[bucket], slot + 1);
+  // Update the number of entities in the bucket
+  ELORankMapFenwickAdd(that, bucket, -1);
+}
+
+// Add the entity 'id' to 'that'
+// Return false if 'that' is full or already contains 'id'
+bool ELORankMapAdd(ELORankMap* const that, const unsigned long id) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // If 'that' is full
+  if (that->_header->_nbEntity >= that->_header->_capacity)
+    return false;
+  // If 'that' already contains the entity
+  unsigned long pos = ELORankMapGetHashPos(that, id);
+  if (that->_hash[pos] != 0)
+    return false;
+  // Create the record at the end of the array of records
+  unsigned int slot = that->_header->_nbEntity;
+  ELORankMapRecord* rec = that->_records + slot;
+  rec->_id = id;
+  rec->_elo = ELORANK_STARTELO;
+  rec->_sumSoftElo = 0.0;
+  rec->_nbRun = 0;
+  rec->_isMilestone = 0;
+  ++(that->_header->_nbEntity);
+  // Add the record to the hash table and rank index
+  that->_hash[pos] = slot + 1;
+  ELORankMapLink(that, slot);
+  return true;
+}
+
+// Remove the entity 'id' from 'that'
+void ELORankMapRemove(ELORankMap* const that, const unsigned long id) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Search the entity
+  unsigned long pos = ELORankMapGetHashPos(that, id);
+  // If we haven't found the entity
+  if (that->_hash[pos] == 0)
+    return;
+  unsigned int slot = that->_hash[pos] - 1;
+  // Remove the record from the rank index and hash table
+  ELORankMapUnlink(that, slot);
+  ELORankMapRemoveHash(that, pos);
+  // Move the last record in the freed slot to keep the array of
+  // records compact
+  unsigned int last = that->_header->_nbEntity - 1;
+  if (slot != last) {
+    ELORankMapRecord* rec = that->_records + slot;
+    memcpy(rec, that->_records + last, sizeof(ELORankMapRecord));
+    that->_hash[ELORankMapGetHashPos(that, rec->_id)] = slot + 1;
+    // Search the reference to the moved record in the tree of its
+    // bucket and update it
+    unsigned int* ref = 
+      that->_roots + ELORankMapGetBucket(that, rec->_elo);
+    while (*ref != last + 1) {
+      ELORankMapRecord* node = that->_records + *ref - 1;
+      ref = (ELORankMapIsBefore(rec, node) ? 
+        &(node->_left) : &(node->_right));
+    }
+    *ref = slot + 1;
+  }
+  --(that->_header->_nbEntity);
+}
+
+// Return true if 'that' contains the entity 'id'
+bool ELORankMapContains(const ELORankMap* const that,
+  const unsigned long id) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return (ELORankMapGetSlot(that, id) != UINT_MAX);
+}
+
+// Update the ranks in 'that' with the results of the 'nb' entities
+// 'ids' whose scores are 'scores' (higher is better, equal means tie)
+// The calculation is the same as ELORankUpdate
+// 'nb' must be at least 2 and the entities must be in 'that'
+void ELORankMapUpdate(ELORankMap* const that, const int nb,
+  const unsigned long* const ids, const float* const scores) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (ids == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'ids' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (scores == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'scores' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (nb < 2) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg,
+      "Number of elements in result set invalid (%d>=2)", nb);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // There is nothing to update with less than two entities, this also
+  // lets the compiler see that the arrays below are filled
+  if (nb < 2)
+    return;
+  // Get the slot of each entity
+  unsigned int slots[nb];
+  for (int i = 0; i < nb; ++i) {
+    slots[i] = ELORankMapGetSlot(that, ids[i]);
+#if BUILDMODE == 0
+    if (slots[i] == UINT_MAX) {
+      ELORankErr->_type = PBErrTypeNullPointer;
+      sprintf(ELORankErr->_msg,
+        "Entity in the result set can't be found in the ELORankMap.");
+      PBErrCatch(ELORankErr);
+    }
+#endif
+  }
+  // Calculate the delta of elo of each entity
+  float elos[nb];
+  float deltaElo[nb];
+  for (int i = 0; i < nb; ++i) {
+    elos[i] = that->_records[slots[i]]._elo;
+    deltaElo[i] = 0.0;
+  }
+  ELORankAddDeltaELO(that->_header->_k, nb, elos, scores, deltaElo);
+  // Apply the delta of elo and update the number of run
+  for (int i = 0; i < nb; ++i) {
+    ELORankMapRecord* rec = that->_records + slots[i];
+    // If the entity is a milestone, its elo is blocked to its current
+    // value
+    if (!(rec->_isMilestone)) {
+      // Move the entity in the rank index
+      ELORankMapUnlink(that, slots[i]);
+      rec->_elo += deltaElo[i];
+      ELORankMapLink(that, slots[i]);
+    }
+    ++(rec->_nbRun);
+    if (rec->_nbRun >= 100) {
+      rec->_sumSoftElo *= 0.99;
+    }
+    rec->_sumSoftElo += rec->_elo;
+  }
+}
+
+// Get the current rank of the entity 'id' (starts at 0)
+unsigned long ELORankMapGetRank(const ELORankMap* const that,
+  const unsigned long id) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Search the entity
+  unsigned int slot = ELORankMapGetSlot(that, id);
+#if BUILDMODE == 0
+  if (slot == UINT_MAX) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg,
+      "Entity requested can't be found in the ELORankMap.");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // The rank is the number of entities in the buckets above the
+  // bucket of the entity plus its position in its bucket
+  const ELORankMapRecord* rec = that->_records + slot;
+  unsigned long bucket = ELORankMapGetBucket(that, rec->_elo);
+  unsigned long rank = that->_header->_nbEntity -
+    ELORankMapFenwickGetPrefix(that, bucket);
+  // Search the entity in the tree of its bucket, counting the entities
+  // ranked before it
+  unsigned int cur = that->_roots[bucket];
+  while (cur != slot + 1) {
+    const ELORankMapRecord* node = that->_records + cur - 1;
+    if (ELORankMapIsBefore(rec, node)) {
+      cur = node->_left;
+    } else {
+      rank += ELORankMapGetNbTree(that, node->_left) + 1;
+      cur = node->_right;
+    }
+  }
+  rank += ELORankMapGetNbTree(that, rec->_left);
+  // Return the rank
+  return rank;
+}
+
+// Get the current ELO of the entity 'id'
+float ELORankMapGetELO(const ELORankMap* const that,
+  const unsigned long id) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Declare a variable to memorize the ELO
+  float elo = ELORANK_STARTELO;
+  // Search the entity
+  unsigned int slot = ELORankMapGetSlot(that, id);
+  if (slot != UINT_MAX) {
+    elo = that->_records[slot]._elo;
+#if BUILDMODE == 0
+  } else {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg,
+      "Entity requested can't be found in the ELORankMap.");
+    PBErrCatch(ELORankErr);
+#endif
+  }
+  // Return the ELO
+  return elo;
+}
+
+// Get the current soft ELO (average of elo over nb of evaluation)
+// of the entity 'id'
+float ELORankMapGetSoftELO(const ELORankMap* const that,
+  const unsigned long id) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Declare a variable to memorize the ELO
+  float elo = ELORANK_STARTELO;
+  // Search the entity
+  unsigned int slot = ELORankMapGetSlot(that, id);
+  if (slot != UINT_MAX) {
+    const ELORankMapRecord* rec = that->_records + slot;
+    if (rec->_nbRun > 0) {
+      elo = rec->_sumSoftElo / (float)MIN(100, rec->_nbRun);
+    }
+#if BUILDMODE == 0
+  } else {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg,
+      "Entity requested can't be found in the ELORankMap.");
+    PBErrCatch(ELORankErr);
+#endif
+  }
+  // Return the ELO
+  return elo;
+}
+
+// Set the current ELO of the entity 'id' to 'elo'
+void ELORankMapSetELO(ELORankMap* const that, const unsigned long id,
+  const float elo) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Search the entity
+  unsigned int slot = ELORankMapGetSlot(that, id);
+  if (slot != UINT_MAX) {
+    // Set the elo and move the entity in the rank index
+    ELORankMapUnlink(that, slot);
+    that->_records[slot]._elo = elo;
+    ELORankMapLink(that, slot);
+#if BUILDMODE == 0
+  } else {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg,
+      "Entity requested can't be found in the ELORankMap.");
+    PBErrCatch(ELORankErr);
+#endif
+  }
+}
+
+// Set the milestone flag of the entity 'id' to 'flag'
+void ELORankMapSetIsMilestone(ELORankMap* const that,
+  const unsigned long id, const bool flag) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Search the entity
+  unsigned int slot = ELORankMapGetSlot(that, id);
+  if (slot != UINT_MAX) {
+    // Set the flag
+    that->_records[slot]._isMilestone = (flag ? 1 : 0);
+#if BUILDMODE == 0
+  } else {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg,
+      "Entity requested can't be found in the ELORankMap.");
+    PBErrCatch(ELORankErr);
+#endif
+  }
+}
+
+// Get the identifier of the 'rank'-th entity according to current ELO
+// of 'that' (starts at 0)
+unsigned long ELORankMapGetRanked(const ELORankMap* const that,
+  const unsigned long rank) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (rank >= that->_header->_nbEntity) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'rank' is invalid (0<=%lu<%lu)", rank,
+      that->_header->_nbEntity);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Search the bucket containing the entity, the rank index counts
+  // from the lowest ELO
+  unsigned long nb = that->_header->_nbEntity;
+  unsigned long bucket = ELORankMapFenwickSearch(that, nb - 1 - rank);
+  // Search the entity in the tree of its bucket
+  unsigned long pos = rank - (nb - ELORankMapFenwickGetPrefix(that, bucket));
+  unsigned int cur = that->_roots[bucket];
+  while (true) {
+    const ELORankMapRecord* node = that->_records + cur - 1;
+    unsigned long nbLeft = ELORankMapGetNbTree(that, node->_left);
+    if (pos < nbLeft) {
+      cur = node->_left;
+    } else if (pos > nbLeft) {
+      pos -= nbLeft + 1;
+      cur = node->_right;
+    } else {
+      return node->_id;
+    }
+  }
+}
@@ -0,0 +1,211 @@
+// ============ ELORANK-MAP.H ================
+
+#ifndef ELORANK_MAP_H
+#define ELORANK_MAP_H
+
+// ================= Include =================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "pberr.h"
+#include "pbmath.h"
+#include "elorank.h"
+
+// ================= Define ==================
+
+#define ELORANKMAP_MAGIC "ELORMAP2"
+// Size reserved for the header at the beginning of the file
+#define ELORANKMAP_HEADERSIZE 64
+// Default resolution of the rank index
+#define ELORANKMAP_RESOLUTION 0.01
+
+// ================= Data structure ===================
+
+// Header of the file
+typedef struct ELORankMapHeader {
+  // Magic string identifying the file
+  char _magic[8];
+  // Maximum number of entities
+  unsigned long _capacity;
+  // Current number of entities
+  unsigned long _nbEntity;
+  // Number of entries in the hash table (power of 2)
+  unsigned long _nbHash;
+  // Number of buckets of the rank index
+  unsigned long _nbBucket;
+  // Number of insertions in the rank index, used to order the entities
+  // of equal ELO
+  unsigned long _nbLink;
+  // ELO of the lowest bucket
+  float _eloMin;
+  // Range of ELO per bucket
+  float _resolution;
+  // ELO coefficient
+  float _k;
+} ELORankMapHeader;
+
+// Fixed size record of an entity
+typedef struct ELORankMapRecord {
+  // Identifier of the entity
+  unsigned long _id;
+  // Insertion number of the record in the rank index, the records of
+  // equal ELO are ranked in increasing insertion number
+  unsigned long _seq;
+  // Current ELO
+  float _elo;
+  // Sum of evaluation
+  float _sumSoftElo;
+  // Number of evaluation
+  unsigned int _nbRun;
+  // Left and right children (slot + 1, 0 if none) of the record in the
+  // tree of its bucket in the rank index, the records ranked before it
+  // are on the left
+  unsigned int _left;
+  unsigned int _right;
+  // Number of records in the subtree of the record
+  unsigned int _nbTree;
+  // Flag to memorize if the entity is a milestone
+  // (whose elo is blocked)
+  unsigned int _isMilestone;
+} ELORankMapRecord;
+
+// ELO ranking stored in a memory-mapped file
+// The file contains the header, the array of records, the hash table
+// from identifiers to records, the root of the tree of each bucket of
+// the rank index and a Fenwick tree of the number of entities per 
+// bucket. Buckets divide the range of ELO in intervals of fixed width,
+// the entities of a bucket are stored in a treap (binary search tree in
+// rank order, balanced by a priority derived from the identifier) 
+// holding the size of each subtree, so the rank of an entity is the
+// number of entities in the buckets above its bucket (given by the 
+// Fenwick tree) plus its position in its bucket (given by the treap),
+// both obtained in logarithmic time even if all the entities are in
+// the same bucket.
+// Only the pages of the file accessed are loaded in memory by the
+// operating system, so the number of entities is bounded by the disk
+// size instead of the memory size.
+typedef struct ELORankMap {
+  // File descriptor
+  int _fd;
+  // Size of the mapping
+  size_t _size;
+  // Mapping of the file
+  void* _map;
+  // Pointers toward the sections of the mapping
+  ELORankMapHeader* _header;
+  ELORankMapRecord* _records;
+  // Hash table (slot + 1 of the record, 0 if empty)
+  unsigned int* _hash;
+  // Root of the tree of each bucket (slot + 1 of the record, 0 if 
+  // empty)
+  unsigned int* _roots;
+  // Fenwick tree of the number of entities per bucket (1-indexed)
+  unsigned int* _fenwick;
+} ELORankMap;
+
+// ================ Functions declaration ====================
+
+// Create a new ELORankMap stored in the file at 'path' (overwritten if
+// it exists) for at most 'capacity' entities, with a rank index
+// covering [eloMin, eloMax] by intervals of 'resolution'
+// ELO outside of [eloMin, eloMax] are ranked in the first or last
+// interval
+// Return NULL if the file couldn't be created
+ELORankMap* ELORankMapCreate(const char* const path,
+  const unsigned long capacity, const float eloMin, const float eloMax,
+  const float resolution);
+
+// Open the ELORankMap stored in the file at 'path'
+// Return NULL if the file couldn't be opened or is not a valid
+// ELORankMap
+ELORankMap* ELORankMapOpen(const char* const path);
+
+// Flush the ELORankMap 'that' to its file
+void ELORankMapSync(const ELORankMap* const that);
+
+// Free memory used by an ELORankMap, the file is kept
+void ELORankMapFree(ELORankMap** that);
+
+// Set the K coefficient of 'that' to 'k'
+#if BUILDMODE != 0
+static inline
+#endif
+void ELORankMapSetK(ELORankMap* const that, const float k);
+
+// Get the K coefficient of 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+float ELORankMapGetK(const ELORankMap* const that);
+
+// Get the number of entity in 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned long ELORankMapGetNb(const ELORankMap* const that);
+
+// Get the maximum number of entity in 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned long ELORankMapGetCapacity(const ELORankMap* const that);
+
+// Add the entity 'id' to 'that'
+// Return false if 'that' is full or already contains 'id'
+bool ELORankMapAdd(ELORankMap* const that, const unsigned long id);
+
+// Remove the entity 'id' from 'that'
+void ELORankMapRemove(ELORankMap* const that, const unsigned long id);
+
+// Return true if 'that' contains the entity 'id'
+bool ELORankMapContains(const ELORankMap* const that,
+  const unsigned long id);
+
+// Update the ranks in 'that' with the results of the 'nb' entities
+// 'ids' whose scores are 'scores' (higher is better, equal means tie)
+// The calculation is the same as ELORankUpdate
+// 'nb' must be at least 2 and the entities must be in 'that'
+void ELORankMapUpdate(ELORankMap* const that, const int nb,
+  const unsigned long* const ids, const float* const scores);
+
+// Get the current rank of the entity 'id' (starts at 0)
+unsigned long ELORankMapGetRank(const ELORankMap* const that,
+  const unsigned long id);
+
+// Get the current ELO of the entity 'id'
+float ELORankMapGetELO(const ELORankMap* const that,
+  const unsigned long id);
+
+// Get the current soft ELO (average of elo over nb of evaluation)
+// of the entity 'id'
+float ELORankMapGetSoftELO(const ELORankMap* const that,
+  const unsigned long id);
+
+// Set the current ELO of the entity 'id' to 'elo'
+void ELORankMapSetELO(ELORankMap* const that, const unsigned long id,
+  const float elo);
+
+// Set the milestone flag of the entity 'id' to 'flag'
+void ELORankMapSetIsMilestone(ELORankMap* const that,
+  const unsigned long id, const bool flag);
+
+// Get the identifier of the 'rank'-th entity according to current ELO
+// of 'that' (starts at 0)
+unsigned long ELORankMapGetRanked(const ELORankMap* const that,
+  const unsigned long rank);
+
+// ================ static inliner ====================
+
+#if BUILDMODE != 0
+#include "elorank-map-inline.c"
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+// ============ ELORANK-POOL-INLINE.C ================
+
+// ================ Functions implementation ====================
+
+// Get the number of entity in 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int ELORankPoolGetNb(const ELORankPool* const that) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_nbEntity;
+}
+
+// Get the number of track in 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int ELORankPoolGetNbTrack(const ELORankPool* const that) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_nbTrack;
+}
+
+// Get the user data of the entity 'id' in 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void* ELORankPoolGetData(const ELORankPool* const that, const int id) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (id < 0 || id >= that->_nbEntity) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'id' is invalid (0<=%d<%d)", id,
+      that->_nbEntity);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_data[id];
+}
+
+// Set the K coefficient of the track 'track' of 'that' to 'k'
+#if BUILDMODE != 0
+static inline
+#endif
+void ELORankPoolSetK(ELORankPool* const that, const int track,
+  const float k) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (track < 0 || track >= that->_nbTrack) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'track' is invalid (0<=%d<%d)", track,
+      that->_nbTrack);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  that->_tracks[track]._k = k;
+}
+
+// Get the K coefficient of the track 'track' of 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+float ELORankPoolGetK(const ELORankPool* const that, const int track) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (track < 0 || track >= that->_nbTrack) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'track' is invalid (0<=%d<%d)", track,
+      that->_nbTrack);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_tracks[track]._k;
+}
+
@@ -0,0 +1,524 @@
+// ============ ELORANK-POOL.C ================
+
+// ================= Include =================
+
+#include "elorank-pool.h"
+#if BUILDMODE == 0
+#include "elorank-pool-inline.c"
+#endif
+
+// ================ Functions declaration ====================
+
+// Reallocate the memory 'ptr' to 'size' bytes
+static void* ELORankPoolRealloc(void* const ptr, const size_t size);
+
+// Allocate the arrays of the track 'track' for the capacity of 'that'
+static void ELORankPoolTrackAlloc(ELORankPool* const that,
+  ELORankPoolTrack* const track);
+
+// Get the first rank in ['first', 'last'[ of the track 'track' whose 
+// entity has an ELO lower than 'elo', or lower or equal if 'orEqual' 
+// is true, or 'last' if there is none
+static int ELORankPoolTrackSearchRank(const ELORankPoolTrack* const track,
+  int first, int last, const float elo, const bool orEqual);
+
+// Move the free rank 'from' of the track 'track' to the rank 'to', the
+// entities in between being shifted by one rank toward 'from'
+static void ELORankPoolTrackMoveHole(ELORankPoolTrack* const track,
+  int from, const int to);
+
+// Move the entity 'id' in the ranking of the track 'track' after its
+// ELO has changed
+static void ELORankPoolTrackMove(ELORankPoolTrack* const track,
+  const int nb, const int id);
+
+// ================ Functions implementation ====================
+
+// Reallocate the memory 'ptr' to 'size' bytes
+static void* ELORankPoolRealloc(void* const ptr, const size_t size) {
+  void* mem = realloc(ptr, size);
+  if (mem == NULL) {
+    ELORankErr->_type = PBErrTypeMallocFailed;
+    sprintf(ELORankErr->_msg, "realloc of %zu bytes failed", size);
+    PBErrCatch(ELORankErr);
+  }
+  return mem;
+}
+
+// Allocate the arrays of the track 'track' for the capacity of 'that'
+static void ELORankPoolTrackAlloc(ELORankPool* const that,
+  ELORankPoolTrack* const track) {
+  track->_ratings = ELORankPoolRealloc(track->_ratings,
+    sizeof(ELORankPoolRating) * that->_capacity);
+  track->_ranked = ELORankPoolRealloc(track->_ranked,
+    sizeof(int) * that->_capacity);
+  track->_ranks = ELORankPoolRealloc(track->_ranks,
+    sizeof(int) * that->_capacity);
+}
+
+// Get the first rank in ['first', 'last'[ of the track 'track' whose 
+// entity has an ELO lower than 'elo', or lower or equal if 'orEqual' 
+// is true, or 'last' if there is none
+static int ELORankPoolTrackSearchRank(const ELORankPoolTrack* const track,
+  int first, int last, const float elo, const bool orEqual) {
+  while (first < last) {
+    int mid = first + (last - first) / 2;
+    float eloMid = track->_ratings[track->_ranked[mid]]._elo;
+    if (eloMid < elo || (orEqual && eloMid == elo))
+      last = mid;
+    else
+      first = mid + 1;
+  }
+  return first;
+}
+
+// Move the free rank 'from' of the track 'track' to the rank 'to', the
+// entities in between being shifted by one rank toward 'from'
+// The entities keep their order of ELO, but inside a run of entities 
+// of equal ELO only the entity at the end of the run opposite to the 
+// free rank is moved, to the free rank
+static void ELORankPoolTrackMoveHole(ELORankPoolTrack* const track,
+  int from, const int to) {
+  // Shift the entities toward the last rank
+  while (from > to) {
+    float elo = track->_ratings[track->_ranked[from - 1]]._elo;
+    int rank = ELORankPoolTrackSearchRank(track, to, from - 1, elo, true);
+    track->_ranked[from] = track->_ranked[rank];
+    track->_ranks[track->_ranked[from]] = from;
+    from = rank;
+  }
+  // Shift the entities toward the first rank
+  while (from < to) {
+    float elo = track->_ratings[track->_ranked[from + 1]]._elo;
+    int rank = 
+      ELORankPoolTrackSearchRank(track, from + 1, to + 1, elo, false) - 1;
+    track->_ranked[from] = track->_ranked[rank];
+    track->_ranks[track->_ranked[from]] = from;
+    from = rank;
+  }
+}
+
+// Move the entity 'id' in the ranking of the track 'track' after its
+// ELO has changed
+// The new rank is searched by dichotomy, and the entities in between 
+// are shifted run of equal ELO by run of equal ELO, so crossing many
+// entities with the start ELO costs as much as crossing one
+// The entity is placed after the entities of higher or equal ELO if it
+// moves toward the first rank, before the entities of lower or equal 
+// ELO else
+static void ELORankPoolTrackMove(ELORankPoolTrack* const track,
+  const int nb, const int id) {
+  float elo = track->_ratings[id]._elo;
+  int rank = track->_ranks[id];
+  int newRank = rank;
+  if (rank > 0 && 
+    track->_ratings[track->_ranked[rank - 1]]._elo < elo)
+    newRank = ELORankPoolTrackSearchRank(track, 0, rank, elo, false);
+  else if (rank < nb - 1 &&
+    track->_ratings[track->_ranked[rank + 1]]._elo > elo)
+    newRank = ELORankPoolTrackSearchRank(track, rank + 1, nb, elo, true) - 1;
+  ELORankPoolTrackMoveHole(track, rank, newRank);
+  track->_ranked[newRank] = id;
+  track->_ranks[id] = newRank;
+}
+
+// Create a new ELORankPool without entity and track
+ELORankPool* ELORankPoolCreate(void) {
+  // Allocate memory
+  ELORankPool* that = PBErrMalloc(ELORankErr, sizeof(ELORankPool));
+  // Set properties
+  that->_nbEntity = 0;
+  that->_capacity = ELORANKPOOL_CAPACITY;
+  that->_data = PBErrMalloc(ELORankErr, sizeof(void*) * that->_capacity);
+  that->_tracks = NULL;
+  that->_nbTrack = 0;
+  // Return the new ELORankPool
+  return that;
+}
+
+// Free memory used by an ELORankPool
+void ELORankPoolFree(ELORankPool** that) {
+  // Check the argument
+  if (that == NULL || *that == NULL) return;
+  // Free memory
+  for (int iTrack = (*that)->_nbTrack; iTrack--;) {
+    free((*that)->_tracks[iTrack]._ratings);
+    free((*that)->_tracks[iTrack]._ranked);
+    free((*that)->_tracks[iTrack]._ranks);
+  }
+  free((*that)->_tracks);
+  free((*that)->_data);
+  free(*that);
+  // Set the pointer to null
+  *that = NULL;
+}
+
+// Add the entity 'data' to 'that' and all its tracks
+// Return the id of the entity
+// Entities can't be removed, to keep the ids dense
+int ELORankPoolAdd(ELORankPool* const that, void* const data) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (data == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'data' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // If there is no more room, double the capacity
+  if (that->_nbEntity == that->_capacity) {
+    that->_capacity *= 2;
+    that->_data = ELORankPoolRealloc(that->_data,
+      sizeof(void*) * that->_capacity);
+    for (int iTrack = that->_nbTrack; iTrack--;)
+      ELORankPoolTrackAlloc(that, that->_tracks + iTrack);
+  }
+  // Register the entity
+  int id = that->_nbEntity;
+  that->_data[id] = data;
+  ++(that->_nbEntity);
+  // Add the entity to each track with the default score
+  for (int iTrack = that->_nbTrack; iTrack--;) {
+    ELORankPoolTrack* track = that->_tracks + iTrack;
+    track->_ratings[id]._elo = ELORANK_STARTELO;
+    track->_ratings[id]._sumSoftElo = 0.0;
+    track->_ratings[id]._nbRun = 0;
+    track->_ratings[id]._isMilestone = false;
+    track->_ranked[id] = id;
+    track->_ranks[id] = id;
+    ELORankPoolTrackMove(track, that->_nbEntity, id);
+  }
+  // Return the id of the entity
+  return id;
+}
+
+// Add a new track with ELO coefficient 'k' to 'that'
+// Return the index of the track
+int ELORankPoolAddTrack(ELORankPool* const that, const float k) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Allocate memory
+  that->_tracks = ELORankPoolRealloc(that->_tracks,
+    sizeof(ELORankPoolTrack) * (that->_nbTrack + 1));
+  ELORankPoolTrack* track = that->_tracks + that->_nbTrack;
+  track->_k = k;
+  track->_ratings = NULL;
+  track->_ranked = NULL;
+  track->_ranks = NULL;
+  ELORankPoolTrackAlloc(that, track);
+  // All the entities start with the default score, in order of id
+  for (int id = 0; id < that->_nbEntity; ++id) {
+    track->_ratings[id]._elo = ELORANK_STARTELO;
+    track->_ratings[id]._sumSoftElo = 0.0;
+    track->_ratings[id]._nbRun = 0;
+    track->_ratings[id]._isMilestone = false;
+    track->_ranked[id] = id;
+    track->_ranks[id] = id;
+  }
+  // Return the index of the track
+  return (that->_nbTrack)++;
+}
+
+// Update the ranks in the track 'track' of 'that' with the results of
+// the 'nb' entities 'ids' whose scores are 'scores' (higher is better,
+// equal means tie)
+// The calculation is the same as ELORankUpdate
+// 'nb' must be at least 2
+void ELORankPoolUpdate(ELORankPool* const that, const int track,
+  const int nb, const int* const ids, const float* const scores) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (ids == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'ids' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (track < 0 || track >= that->_nbTrack) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'track' is invalid (0<=%d<%d)", track,
+      that->_nbTrack);
+    PBErrCatch(ELORankErr);
+  }
+  if (nb < 2) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg,
+      "Number of elements in result set invalid (%d>=2)", nb);
+    PBErrCatch(ELORankErr);
+  }
+  for (int i = 0; i < nb; ++i) {
+    if (ids[i] < 0 || ids[i] >= that->_nbEntity) {
+      ELORankErr->_type = PBErrTypeInvalidArg;
+      sprintf(ELORankErr->_msg, "'ids[%d]' is invalid (0<=%d<%d)", i,
+        ids[i], that->_nbEntity);
+      PBErrCatch(ELORankErr);
+    }
+  }
+#endif
+  // There is nothing to update with less than two entities, this also
+  // lets the compiler see that the arrays below are filled
+  if (nb < 2)
+    return;
+  ELORankPoolTrack* t = that->_tracks + track;
+  // Calculate the delta of elo of each entity
+  float elos[nb];
+  float deltaElo[nb];
+  for (int i = 0; i < nb; ++i) {
+    elos[i] = t->_ratings[ids[i]]._elo;
+    deltaElo[i] = 0.0;
+  }
+  ELORankAddDeltaELO(t->_k, nb, elos, scores, deltaElo);
+  // Apply the delta of elo and update the number of run
+  for (int i = 0; i < nb; ++i) {
+    ELORankPoolRating* rating = t->_ratings + ids[i];
+    // If the entity is a milestone, its elo is blocked to its current
+    // value
+    if (!(rating->_isMilestone)) {
+      rating->_elo += deltaElo[i];
+      ELORankPoolTrackMove(t, that->_nbEntity, ids[i]);
+    }
+    ++(rating->_nbRun);
+    if (rating->_nbRun >= 100) {
+      rating->_sumSoftElo *= 0.99;
+    }
+    rating->_sumSoftElo += rating->_elo;
+  }
+}
+
+// Get the current rank of the entity 'id' in the track 'track'
+// (starts at 0)
+int ELORankPoolGetRank(const ELORankPool* const that, const int track,
+  const int id) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (track < 0 || track >= that->_nbTrack) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'track' is invalid (0<=%d<%d)", track,
+      that->_nbTrack);
+    PBErrCatch(ELORankErr);
+  }
+  if (id < 0 || id >= that->_nbEntity) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'id' is invalid (0<=%d<%d)", id,
+      that->_nbEntity);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_tracks[track]._ranks[id];
+}
+
+// Get the current ELO of the entity 'id' in the track 'track'
+float ELORankPoolGetELO(const ELORankPool* const that, const int track,
+  const int id) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (track < 0 || track >= that->_nbTrack) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'track' is invalid (0<=%d<%d)", track,
+      that->_nbTrack);
+    PBErrCatch(ELORankErr);
+  }
+  if (id < 0 || id >= that->_nbEntity) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'id' is invalid (0<=%d<%d)", id,
+      that->_nbEntity);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_tracks[track]._ratings[id]._elo;
+}
+
+// Get the current soft ELO (average of elo over nb of evaluation)
+// of the entity 'id' in the track 'track'
+float ELORankPoolGetSoftELO(const ELORankPool* const that,
+  const int track, const int id) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (track < 0 || track >= that->_nbTrack) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'track' is invalid (0<=%d<%d)", track,
+      that->_nbTrack);
+    PBErrCatch(ELORankErr);
+  }
+  if (id < 0 || id >= that->_nbEntity) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'id' is invalid (0<=%d<%d)", id,
+      that->_nbEntity);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Declare a variable to memorize the ELO
+  float elo = ELORANK_STARTELO;
+  const ELORankPoolRating* rating = that->_tracks[track]._ratings + id;
+  if (rating->_nbRun > 0) {
+    elo = rating->_sumSoftElo / (float)MIN(100, rating->_nbRun);
+  }
+  // Return the ELO
+  return elo;
+}
+
+// Get the current rank of the entity 'id' in all the tracks
+// 'ranks' is an array of ELORankPoolGetNbTrack(that) int
+void ELORankPoolGetRanks(const ELORankPool* const that, const int id,
+  int* const ranks) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (ranks == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'ranks' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (id < 0 || id >= that->_nbEntity) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'id' is invalid (0<=%d<%d)", id,
+      that->_nbEntity);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  for (int iTrack = that->_nbTrack; iTrack--;)
+    ranks[iTrack] = that->_tracks[iTrack]._ranks[id];
+}
+
+// Get the current ELO of the entity 'id' in all the tracks
+// 'elos' is an array of ELORankPoolGetNbTrack(that) float
+void ELORankPoolGetELOs(const ELORankPool* const that, const int id,
+  float* const elos) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (elos == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'elos' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (id < 0 || id >= that->_nbEntity) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'id' is invalid (0<=%d<%d)", id,
+      that->_nbEntity);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  for (int iTrack = that->_nbTrack; iTrack--;)
+    elos[iTrack] = that->_tracks[iTrack]._ratings[id]._elo;
+}
+
+// Set the current ELO of the entity 'id' in the track 'track' to 'elo'
+void ELORankPoolSetELO(ELORankPool* const that, const int track,
+  const int id, const float elo) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (track < 0 || track >= that->_nbTrack) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'track' is invalid (0<=%d<%d)", track,
+      that->_nbTrack);
+    PBErrCatch(ELORankErr);
+  }
+  if (id < 0 || id >= that->_nbEntity) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'id' is invalid (0<=%d<%d)", id,
+      that->_nbEntity);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Set the elo and move the entity in the ranking
+  that->_tracks[track]._ratings[id]._elo = elo;
+  ELORankPoolTrackMove(that->_tracks + track, that->_nbEntity, id);
+}
+
+// Set the milestone flag of the entity 'id' in the track 'track' to
+// 'flag'
+void ELORankPoolSetIsMilestone(ELORankPool* const that,
+  const int track, const int id, const bool flag) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (track < 0 || track >= that->_nbTrack) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'track' is invalid (0<=%d<%d)", track,
+      that->_nbTrack);
+    PBErrCatch(ELORankErr);
+  }
+  if (id < 0 || id >= that->_nbEntity) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'id' is invalid (0<=%d<%d)", id,
+      that->_nbEntity);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  that->_tracks[track]._ratings[id]._isMilestone = flag;
+}
+
+// Get the id of the 'rank'-th entity according to current ELO in the
+// track 'track' of 'that' (starts at 0)
+int ELORankPoolGetRanked(const ELORankPool* const that, const int track,
+  const int rank) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (track < 0 || track >= that->_nbTrack) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'track' is invalid (0<=%d<%d)", track,
+      that->_nbTrack);
+    PBErrCatch(ELORankErr);
+  }
+  if (rank < 0 || rank >= that->_nbEntity) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'rank' is invalid (0<=%d<%d)", rank,
+      that->_nbEntity);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  return that->_tracks[track]._ranked[rank];
+}
@@ -0,0 +1,167 @@
+// ============ ELORANK-POOL.H ================
+
+#ifndef ELORANK_POOL_H
+#define ELORANK_POOL_H
+
+// ================= Include =================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <stdbool.h>
+#include "pberr.h"
+#include "pbmath.h"
+#include "elorank.h"
+
+// ================= Define ==================
+
+// Initial number of entities allocated in a pool
+#define ELORANKPOOL_CAPACITY 16
+
+// ================= Data structure ===================
+
+// Rating of an entity in one track
+typedef struct ELORankPoolRating {
+  // Current ELO
+  float _elo;
+  // Sum of evaluation
+  float _sumSoftElo;
+  // Number of evaluation
+  int _nbRun;
+  // Flag to memorize if the entity is a milestone
+  // (whose elo is blocked)
+  bool _isMilestone;
+} ELORankPoolRating;
+
+// Ranking of the entities of the pool, for example for one game mode
+// or one season
+typedef struct ELORankPoolTrack {
+  // ELO coefficient
+  float _k;
+  // Rating of each entity, indexed by the id of the entity
+  ELORankPoolRating* _ratings;
+  // Id of the entities in decreasing order of ELO
+  int* _ranked;
+  // Rank of each entity, indexed by the id of the entity
+  int* _ranks;
+} ELORankPoolTrack;
+
+// Pool of entities shared by several tracks
+// Each entity is registered once and identified by a dense id (its
+// index of registration), each track holds only a compact rating per
+// entity
+typedef struct ELORankPool {
+  // Pointer toward user struct of each entity, indexed by id
+  void** _data;
+  // Number of entities
+  int _nbEntity;
+  // Number of entities allocated
+  int _capacity;
+  // Tracks
+  ELORankPoolTrack* _tracks;
+  // Number of tracks
+  int _nbTrack;
+} ELORankPool;
+
+// ================ Functions declaration ====================
+
+// Create a new ELORankPool without entity and track
+ELORankPool* ELORankPoolCreate(void);
+
+// Free memory used by an ELORankPool
+void ELORankPoolFree(ELORankPool** that);
+
+// Get the number of entity in 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int ELORankPoolGetNb(const ELORankPool* const that);
+
+// Get the number of track in 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int ELORankPoolGetNbTrack(const ELORankPool* const that);
+
+// Get the user data of the entity 'id' in 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void* ELORankPoolGetData(const ELORankPool* const that, const int id);
+
+// Set the K coefficient of the track 'track' of 'that' to 'k'
+#if BUILDMODE != 0
+static inline
+#endif
+void ELORankPoolSetK(ELORankPool* const that, const int track,
+  const float k);
+
+// Get the K coefficient of the track 'track' of 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+float ELORankPoolGetK(const ELORankPool* const that, const int track);
+
+// Add the entity 'data' to 'that' and all its tracks
+// Return the id of the entity
+// Entities can't be removed, to keep the ids dense
+int ELORankPoolAdd(ELORankPool* const that, void* const data);
+
+// Add a new track with ELO coefficient 'k' to 'that'
+// Return the index of the track
+int ELORankPoolAddTrack(ELORankPool* const that, const float k);
+
+// Update the ranks in the track 'track' of 'that' with the results of
+// the 'nb' entities 'ids' whose scores are 'scores' (higher is better,
+// equal means tie)
+// The calculation is the same as ELORankUpdate
+// 'nb' must be at least 2
+void ELORankPoolUpdate(ELORankPool* const that, const int track,
+  const int nb, const int* const ids, const float* const scores);
+
+// Get the current rank of the entity 'id' in the track 'track'
+// (starts at 0)
+int ELORankPoolGetRank(const ELORankPool* const that, const int track,
+  const int id);
+
+// Get the current ELO of the entity 'id' in the track 'track'
+float ELORankPoolGetELO(const ELORankPool* const that, const int track,
+  const int id);
+
+// Get the current soft ELO (average of elo over nb of evaluation)
+// of the entity 'id' in the track 'track'
+float ELORankPoolGetSoftELO(const ELORankPool* const that,
+  const int track, const int id);
+
+// Get the current rank of the entity 'id' in all the tracks
+// 'ranks' is an array of ELORankPoolGetNbTrack(that) int
+void ELORankPoolGetRanks(const ELORankPool* const that, const int id,
+  int* const ranks);
+
+// Get the current ELO of the entity 'id' in all the tracks
+// 'elos' is an array of ELORankPoolGetNbTrack(that) float
+void ELORankPoolGetELOs(const ELORankPool* const that, const int id,
+  float* const elos);
+
+// Set the current ELO of the entity 'id' in the track 'track' to 'elo'
+void ELORankPoolSetELO(ELORankPool* const that, const int track,
+  const int id, const float elo);
+
+// Set the milestone flag of the entity 'id' in the track 'track' to
+// 'flag'
+void ELORankPoolSetIsMilestone(ELORankPool* const that,
+  const int track, const int id, const bool flag);
+
+// Get the id of the 'rank'-th entity according to current ELO in the
+// track 'track' of 'that' (starts at 0)
+int ELORankPoolGetRanked(const ELORankPool* const that, const int track,
+  const int rank);
+
+// ================ static inliner ====================
+
+#if BUILDMODE != 0
+#include "elorank-pool-inline.c"
+#endif
+
+#endif
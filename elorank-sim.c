@@ -0,0 +1,348 @@
+// ============ ELORANK-SIM.C ================
+
+// ================= Include =================
+
+#include "elorank-sim.h"
+
+// ================= Data structure ===================
+
+// Simulated entity
+typedef struct ELOSimEntity {
+  // Index of the entity
+  int _id;
+  // True skill of the entity
+  float _skill;
+  // Rank of the entity according to its true skill (starts at 0)
+  int _skillRank;
+} ELOSimEntity;
+
+// Work shared by the threads of a batch of simulations
+typedef struct ELOSimBatch {
+  // Parameters of the simulations
+  const ELOSimParam* _param;
+  // Seed of the first simulation
+  unsigned long _seed;
+  // Number of simulations
+  int _nbSim;
+  // Results of the simulations
+  ELOSimResult* _results;
+  // Index of the next simulation to run
+  int _iNext;
+  // Mutex protecting _iNext
+  pthread_mutex_t _mutex;
+} ELOSimBatch;
+
+// ================ Functions declaration ====================
+
+// Return the next pseudo random number of the generator 'state'
+// (splitmix64, the generator is local to each simulation to make them
+// reproducible and independant of the other threads)
+static unsigned long ELOSimRndNext(unsigned long* const state);
+
+// Return a pseudo random number in [0.0, 1.0[ from the generator
+// 'state'
+static float ELOSimRnd(unsigned long* const state);
+
+// Return a pseudo random number following a gaussian distribution of
+// mean 'mean' and standard deviation 'sigma' from the generator 'state'
+static float ELOSimGaussRnd(unsigned long* const state, const float mean,
+  const float sigma);
+
+// Compare the true skill of the entities 'a' and 'b' for qsort in
+// decreasing order
+static int ELOSimCmpSkill(const void* a, const void* b);
+
+// Return the Spearman rank correlation between the rank of entities
+// in 'elo' and their true skill rank
+static float ELOSimGetRankCorrelation(const ELORank* const elo);
+
+// Return the root mean square error between the ELO of the entities
+// in 'elo' and the ELO expected from their true skill given the 
+// standard deviation of performance 'perfSigma'
+static float ELOSimGetELOError(const ELORank* const elo,
+  const float perfSigma);
+
+// Main function of the threads of a batch of simulations
+static void* ELOSimBatchWorker(void* arg);
+
+// ================ Functions implementation ====================
+
+// Create a static ELOSimParam with default values
+ELOSimParam ELOSimParamCreateStatic(void) {
+  // Declare the new ELOSimParam
+  ELOSimParam that;
+  // Set the default values
+  that._nbEntity = ELOSIM_NBENTITY;
+  that._matchSize = ELOSIM_MATCHSIZE;
+  that._nbMatch = ELOSIM_NBMATCH;
+  that._skillDist = ELOSimSkillDistGauss;
+  that._skillMean = ELOSIM_SKILLMEAN;
+  that._skillSpread = ELOSIM_SKILLSPREAD;
+  that._perfSigma = ELOSIM_PERFSIGMA;
+  that._k = ELORANK_K;
+  that._convergence = ELOSIM_CONVERGENCE;
+  that._nbCheck = ELOSIM_NBCHECK;
+  // Return the new ELOSimParam
+  return that;
+}
+
+// Return the next pseudo random number of the generator 'state'
+static unsigned long ELOSimRndNext(unsigned long* const state) {
+  unsigned long z = (*state += 0x9E3779B97F4A7C15UL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+  return z ^ (z >> 31);
+}
+
+// Return a pseudo random number in [0.0, 1.0[ from the generator
+// 'state'
+static float ELOSimRnd(unsigned long* const state) {
+  return (float)(ELOSimRndNext(state) >> 40) / (float)(1UL << 24);
+}
+
+// Return a pseudo random number following a gaussian distribution of
+// mean 'mean' and standard deviation 'sigma' from the generator 'state'
+static float ELOSimGaussRnd(unsigned long* const state, const float mean,
+  const float sigma) {
+  // Box-Muller transform
+  float u = 1.0 - ELOSimRnd(state);
+  float v = ELOSimRnd(state);
+  return mean + sigma * sqrt(-2.0 * log(u)) * cos(2.0 * PBMATH_PI * v);
+}
+
+// Compare the true skill of the entities 'a' and 'b' for qsort in
+// decreasing order
+static int ELOSimCmpSkill(const void* a, const void* b) {
+  float skillA = (*(ELOSimEntity**)a)->_skill;
+  float skillB = (*(ELOSimEntity**)b)->_skill;
+  return (skillA < skillB) - (skillA > skillB);
+}
+
+// Return the Spearman rank correlation between the rank of entities
+// in 'elo' and their true skill rank
+static float ELOSimGetRankCorrelation(const ELORank* const elo) {
+  // Sum the square of the differences of rank, walking the set from
+  // the highest ELO
+  double sumSq = 0.0;
+  int rank = 0;
+  GSetElem* elem = elo->_set._tail;
+  while (elem != NULL) {
+    ELOSimEntity* ent = (ELOSimEntity*)(((ELOEntity*)(elem->_data))->_data);
+    double d = (double)(rank - ent->_skillRank);
+    sumSq += d * d;
+    ++rank;
+    elem = elem->_prev;
+  }
+  double n = (double)rank;
+  return 1.0 - 6.0 * sumSq / (n * (n * n - 1.0));
+}
+
+// Return the root mean square error between the ELO of the entities
+// in 'elo' and the ELO expected from their true skill given the 
+// standard deviation of performance 'perfSigma'
+// The probability of A beating B in a match is
+// Phi((skillA - skillB) / (perfSigma * sqrt(2))), which is
+// approximated with the logistic function of the ELO model. Both the
+// ELO and the expected ELO are centered on their mean. The ELORank of
+// the simulation has no decay, so the ELO of an entity is the sort
+// value of its element.
+static float ELOSimGetELOError(const ELORank* const elo,
+  const float perfSigma) {
+  // Scale from the skill to the ELO
+  double scale = 400.0 * 1.702 / (log(10.0) * perfSigma * sqrt(2.0));
+  // Get the mean of the ELO and skill, walking the set
+  double meanELO = 0.0;
+  double meanSkill = 0.0;
+  GSetElem* elem = elo->_set._head;
+  while (elem != NULL) {
+    ELOSimEntity* ent = (ELOSimEntity*)(((ELOEntity*)(elem->_data))->_data);
+    meanELO += elem->_sortVal;
+    meanSkill += ent->_skill;
+    elem = elem->_next;
+  }
+  double nb = (double)GSetNbElem(&(elo->_set));
+  meanELO /= nb;
+  meanSkill /= nb;
+  // Calculate the error
+  double sumSq = 0.0;
+  elem = elo->_set._head;
+  while (elem != NULL) {
+    ELOSimEntity* ent = (ELOSimEntity*)(((ELOEntity*)(elem->_data))->_data);
+    double d = (elem->_sortVal - meanELO) - scale * (ent->_skill - meanSkill);
+    sumSq += d * d;
+    elem = elem->_next;
+  }
+  return sqrt(sumSq / nb);
+}
+
+// Run one simulation with parameters 'param' and random seed 'seed'
+// and store the result in 'result'
+// The result depends only on 'param' and 'seed'
+void ELOSimRun(const ELOSimParam* const param, const unsigned long seed,
+  ELOSimResult* const result) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (param == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'param' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (result == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'result' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (param->_matchSize < 2 || param->_matchSize > param->_nbEntity) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'_matchSize' is invalid (2<=%d<=%d)",
+      param->_matchSize, param->_nbEntity);
+    PBErrCatch(ELORankErr);
+  }
+  if (param->_nbCheck < 1) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'_nbCheck' is invalid (1<=%d)",
+      param->_nbCheck);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Initialise the random generator
+  unsigned long rndState = seed;
+  // Create the entities with their true skill
+  int nb = param->_nbEntity;
+  ELOSimEntity* entities =
+    PBErrMalloc(ELORankErr, sizeof(ELOSimEntity) * nb);
+  ELOSimEntity** sorted =
+    PBErrMalloc(ELORankErr, sizeof(ELOSimEntity*) * nb);
+  int* picks = PBErrMalloc(ELORankErr, sizeof(int) * nb);
+  ELORank* elo = ELORankCreate();
+  ELORankSetK(elo, param->_k);
+  for (int iEnt = 0; iEnt < nb; ++iEnt) {
+    entities[iEnt]._id = iEnt;
+    if (param->_skillDist == ELOSimSkillDistUniform)
+      entities[iEnt]._skill = param->_skillMean +
+        param->_skillSpread * (2.0 * ELOSimRnd(&rndState) - 1.0);
+    else
+      entities[iEnt]._skill = ELOSimGaussRnd(&rndState,
+        param->_skillMean, param->_skillSpread);
+    sorted[iEnt] = entities + iEnt;
+    picks[iEnt] = iEnt;
+    ELORankAdd(elo, entities + iEnt);
+  }
+  // Get the rank of entities according to their true skill
+  qsort(sorted, nb, sizeof(ELOSimEntity*), ELOSimCmpSkill);
+  for (int iEnt = 0; iEnt < nb; ++iEnt)
+    sorted[iEnt]->_skillRank = iEnt;
+  // Loop on matches
+  GSet res = GSetCreateStatic();
+  int lastBelow = 0;
+  float corr = 0.0;
+  for (int iMatch = 0; iMatch < param->_nbMatch; ++iMatch) {
+    // Pick the entities of this match (partial Fisher-Yates shuffle)
+    // and their performance
+    GSetFlush(&res);
+    for (int iPick = 0; iPick < param->_matchSize; ++iPick) {
+      int jPick = iPick +
+        (int)(ELOSimRndNext(&rndState) % (unsigned long)(nb - iPick));
+      int tmp = picks[iPick];
+      picks[iPick] = picks[jPick];
+      picks[jPick] = tmp;
+      ELOSimEntity* ent = entities + picks[iPick];
+      GSetAddSort(&res, ent,
+        ELOSimGaussRnd(&rndState, ent->_skill, param->_perfSigma));
+    }
+    // Update the ranking
+    ELORankUpdate(elo, &res);
+    // Measure the ranking
+    if ((iMatch + 1) % param->_nbCheck == 0 ||
+      iMatch + 1 == param->_nbMatch) {
+      corr = ELOSimGetRankCorrelation(elo);
+      if (corr < param->_convergence)
+        lastBelow = iMatch + 1;
+    }
+  }
+  // Set the result
+  result->_seed = seed;
+  result->_convergence =
+    (param->_nbMatch > 0 && corr >= param->_convergence ? lastBelow : -1);
+  result->_rankCorrelation = corr;
+  result->_eloError =
+    ELOSimGetELOError(elo, param->_perfSigma);
+  // Free memory
+  GSetFlush(&res);
+  ELORankFree(&elo);
+  free(picks);
+  free(sorted);
+  free(entities);
+}
+
+// Main function of the threads of a batch of simulations
+static void* ELOSimBatchWorker(void* arg) {
+  ELOSimBatch* batch = (ELOSimBatch*)arg;
+  while (true) {
+    // Get the index of the next simulation
+    pthread_mutex_lock(&(batch->_mutex));
+    int iSim = batch->_iNext;
+    ++(batch->_iNext);
+    pthread_mutex_unlock(&(batch->_mutex));
+    // If there is no more simulations, stop here
+    if (iSim >= batch->_nbSim)
+      break;
+    // Run the simulation
+    ELOSimRun(batch->_param, batch->_seed + (unsigned long)iSim,
+      batch->_results + iSim);
+  }
+  return NULL;
+}
+
+// Run 'nbSim' simulations with parameters 'param' on 'nbThread'
+// threads and store the results in 'results' (array of 'nbSim'
+// ELOSimResult)
+// The i-th simulation uses the seed 'seed' + i, so results are the
+// same whatever the number of threads
+void ELOSimRunBatch(const ELOSimParam* const param,
+  const unsigned long seed, const int nbSim, const int nbThread,
+  ELOSimResult* const results) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (param == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'param' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (results == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'results' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (nbThread < 1) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'nbThread' is invalid (1<=%d)", nbThread);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Initialise the shared work
+  ELOSimBatch batch;
+  batch._param = param;
+  batch._seed = seed;
+  batch._nbSim = nbSim;
+  batch._results = results;
+  batch._iNext = 0;
+  pthread_mutex_init(&(batch._mutex), NULL);
+  // Start the threads, the current thread is used as one of them
+  int nbExtra = MIN(nbThread, nbSim) - 1;
+  pthread_t* threads = NULL;
+  if (nbExtra > 0)
+    threads = PBErrMalloc(ELORankErr, sizeof(pthread_t) * nbExtra);
+  int nbStarted = 0;
+  for (int iThread = 0; iThread < nbExtra; ++iThread)
+    if (pthread_create(threads + nbStarted, NULL, ELOSimBatchWorker,
+      &batch) == 0)
+      ++nbStarted;
+  (void)ELOSimBatchWorker(&batch);
+  // Wait for the threads
+  for (int iThread = 0; iThread < nbStarted; ++iThread)
+    pthread_join(threads[iThread], NULL);
+  // Free memory
+  free(threads);
+  pthread_mutex_destroy(&(batch._mutex));
+}
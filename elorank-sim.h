@@ -0,0 +1,99 @@
+// ============ ELORANK-SIM.H ================
+
+#ifndef ELORANK_SIM_H
+#define ELORANK_SIM_H
+
+// ================= Include =================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "pberr.h"
+#include "gset.h"
+#include "pbmath.h"
+#include "elorank.h"
+
+// ================= Define ==================
+
+#define ELOSIM_NBENTITY 100
+#define ELOSIM_MATCHSIZE 2
+#define ELOSIM_NBMATCH 10000
+#define ELOSIM_SKILLMEAN 0.0
+#define ELOSIM_SKILLSPREAD 1.0
+#define ELOSIM_PERFSIGMA 1.0
+#define ELOSIM_CONVERGENCE 0.9
+#define ELOSIM_NBCHECK 100
+
+// ================= Data structure ===================
+
+// Distribution of the true skill of the simulated entities
+typedef enum ELOSimSkillDist {
+  // Gaussian distribution (spread is the standard deviation)
+  ELOSimSkillDistGauss,
+  // Uniform distribution (spread is the half width)
+  ELOSimSkillDistUniform
+} ELOSimSkillDist;
+
+typedef struct ELOSimParam {
+  // Number of entities
+  int _nbEntity;
+  // Number of entities per match
+  int _matchSize;
+  // Number of matches per simulation
+  int _nbMatch;
+  // Distribution of the true skill
+  ELOSimSkillDist _skillDist;
+  // Mean of the true skill
+  float _skillMean;
+  // Spread of the true skill
+  float _skillSpread;
+  // Standard deviation of the performance of an entity in one match
+  // around its true skill
+  float _perfSigma;
+  // ELO coefficient
+  float _k;
+  // Rank correlation above which the ranking is considered converged
+  float _convergence;
+  // Number of matches between two measures of the ranking
+  int _nbCheck;
+} ELOSimParam;
+
+typedef struct ELOSimResult {
+  // Seed of the simulation
+  unsigned long _seed;
+  // Number of matches after which the rank correlation stays above
+  // the convergence threshold until the end of the simulation
+  // (-1 if it never converged)
+  int _convergence;
+  // Spearman rank correlation between the ELO and the true skill at
+  // the end of the simulation
+  float _rankCorrelation;
+  // Root mean square error between the ELO and the ELO expected from
+  // the true skill at the end of the simulation
+  float _eloError;
+} ELOSimResult;
+
+// ================ Functions declaration ====================
+
+// Create a static ELOSimParam with default values
+ELOSimParam ELOSimParamCreateStatic(void);
+
+// Run one simulation with parameters 'param' and random seed 'seed'
+// and store the result in 'result'
+// The result depends only on 'param' and 'seed'
+void ELOSimRun(const ELOSimParam* const param, const unsigned long seed,
+  ELOSimResult* const result);
+
+// Run 'nbSim' simulations with parameters 'param' on 'nbThread'
+// threads and store the results in 'results' (array of 'nbSim'
+// ELOSimResult)
+// The i-th simulation uses the seed 'seed' + i, so results are the
+// same whatever the number of threads
+void ELOSimRunBatch(const ELOSimParam* const param,
+  const unsigned long seed, const int nbSim, const int nbThread,
+  ELOSimResult* const results);
+
+#endif
@@ -12,8 +12,110 @@
 // Create a new ELOEntity
 static ELOEntity* ELOEntityCreate(void* const data);
 
-// Return the GSetElem in 'that'->_set for the entity 'data'
-static GSetElem* ELORankGetElem(const ELORank* const that, const void* const data);
+// Return the GSetElem in 'that'->_set for the entity 'data', without
+// searching in the parents of 'that'
+static GSetElem* ELORankGetSetElem(const ELORank* const that, 
+  const void* const data);
+
+// Return the position in the index of 'that' of the entity 'data' if 
+// it's in 'that'->_set, or of the empty entry where it would be added
+// else
+static unsigned long ELORankGetIndexPos(const ELORank* const that,
+  const void* const data);
+
+// Add the entity 'ent' to 'that'->_set with the sort value 'key' and
+// to the index of 'that'
+// Return the new element
+static GSetElem* ELORankAddElem(ELORank* const that, 
+  ELOEntity* const ent, const float key);
+
+// Remove the entity 'data' from the index of 'that'
+static void ELORankRemoveIndex(ELORank* const that, 
+  const void* const data);
+
+// Return true if the element for the entity 'data' in 'owner', a 
+// parent of 'that', is hidden by a copy in 'that' or one of the 
+// parents between 'that' and 'owner'
+static bool ELORankIsHidden(const ELORank* const that, 
+  const ELORank* const owner, const void* const data);
+
+// Return the GSetElem for the entity 'data' as seen from 'that', i.e. 
+// searching in 'that'->_set and then in the parents of 'that'
+// If 'owner' is not null it's set to the ELORank holding the element
+static GSetElem* ELORankGetElem(const ELORank* const that, 
+  const void* const data, const ELORank** const owner);
+
+// Return the GSetElem in 'that'->_set for the entity 'data', copying
+// it from the parents of 'that' if necessary (copy-on-write)
+static GSetElem* ELORankGetOwnElem(ELORank* const that, 
+  const void* const data);
+
+// Return the 'rank'-th element (if 'data' is null) or the element for
+// the entity 'data' (else) according to current ELO as seen from 'that'
+// If 'pos' is not null it's set to the rank of the returned element
+static GSetElem* ELORankWalk(const ELORank* const that, const int rank,
+  const void* const data, int* const pos);
+
+// Convert the sort value 'key' of an entity in 'that' into its ELO at 
+// time 't'
+static float ELORankKeyToELO(const ELORank* const that, const float key,
+  const long t);
+
+// Convert the ELO 'elo' at time 't' of an entity in 'that' into its 
+// sort value
+static float ELORankELOToKey(const ELORank* const that, const float elo,
+  const long t);
+
+// Carry the sort values of the entities in 'that' to the current time
+static void ELORankRebaseDecay(ELORank* const that);
+
+// Move the element 'elem' of 'set' to its position according to its 
+// sort value, the other elements being sorted
+static void ELORankMoveElem(GSet* const set, GSetElem* const elem);
+
+// Remove the element 'elem' of 'that'->_set from 'that'->_milestones
+static void ELORankRemoveMilestone(ELORank* const that, 
+  const GSetElem* const elem);
+
+// Apply the results 'res' to the entities of 'that' without sorting 
+// the set of entities (cf ELORankUpdate)
+static void ELORankApplyResult(ELORank* const that, 
+  const GSet* const res);
+
+// Create a new empty ELOHistory of 'capacity' bytes
+static ELOHistory* ELOHistoryCreate(const int capacity);
+
+// Return a copy of the ELOHistory 'that'
+static ELOHistory* ELOHistoryClone(const ELOHistory* const that);
+
+// Return the ELOHistory 'that' resized to 'capacity' bytes, keeping its
+// most recent samples, or NULL if 'capacity' is 0
+// 'that' is freed
+static ELOHistory* ELOHistoryResize(ELOHistory* const that, 
+  const int capacity);
+
+// Add the sample ('match', 'elo') at the end of the ELOHistory 'that'
+static void ELOHistoryPush(ELOHistory* const that, const long match,
+  const float elo);
+
+// Drop the oldest sample of the ELOHistory 'that'
+static void ELOHistoryDrop(ELOHistory* const that);
+
+// Copy the 'nb' most recent samples of the ELOHistory 'that' into 
+// 'matches' and 'elos' (which can be null)
+// Return the number of samples copied
+static int ELOHistoryGet(const ELOHistory* const that, const int nb,
+  long* const matches, float* const elos);
+
+// Read the variable length integer at position 'pos' in the buffer of
+// the ELOHistory 'that', move 'pos' after it and add its number of 
+// bytes to 'nbByte'
+static unsigned long ELOHistoryRead(const ELOHistory* const that, 
+  int* const pos, int* const nbByte);
+
+// Write the variable length integer 'val' in 'bytes'
+// Return the number of bytes written
+static int ELOHistoryWrite(unsigned long val, unsigned char* const bytes);
 
 // ================ Functions implementation ====================
 
@@ -25,14 +127,61 @@ ELORank* ELORankCreate(void) {
   that->_k = ELORANK_K;
   // Create the set of entities
   that->_set = GSetCreateStatic();
+  that->_milestones = GSetCreateStatic();
+  that->_index = NULL;
+  that->_nbIndex = 0;
+  // Set the default decay and the time
+  that->_decay = ELORANK_DECAY;
+  that->_time = 0;
+  that->_decayEpoch = 0;
+  // By default the ELORank is not a fork
+  that->_parent = NULL;
+  // No result applied yet
+  that->_nbMatch = 0;
   // Return the new ELORank
   return that;
 }
 
+// Create a fork of the ELORank 'that'
+// The fork shares the entities of 'that' and holds only a copy of the
+// entities modified through the fork (copy-on-write). The fork can be 
+// updated like any other ELORank, except it is not possible to add or
+// remove entities, or to modify its decay rate. 'that' must not be
+// modified nor freed as long as the fork exists. A fork can be forked
+// too.
+ELORank* ELORankFork(const ELORank* const that) {
+#if BUILDMODE == 0
+  // Check argument
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Allocate memory
+  ELORank* fork = PBErrMalloc(ELORankErr, sizeof(ELORank));
+  // Copy the properties of the parent
+  fork->_k = that->_k;
+  fork->_decay = that->_decay;
+  fork->_time = that->_time;
+  fork->_decayEpoch = that->_decayEpoch;
+  fork->_parent = that;
+  fork->_nbMatch = that->_nbMatch;
+  // The fork starts with no entities of its own
+  fork->_set = GSetCreateStatic();
+  fork->_milestones = GSetCreateStatic();
+  fork->_index = NULL;
+  fork->_nbIndex = 0;
+  // Return the new ELORank
+  return fork;
+}
+
 // Free memory used by an ELORank
 void ELORankFree(ELORank** that) {
   // Check the argument
   if (that == NULL || *that == NULL) return;
+  // Empty the set of milestones
+  GSetFlush(&((*that)->_milestones));
   // Empty the set of entities
   GSet* set = &((*that)->_set);
   while (GSetNbElem(set) > 0) {
@@ -40,6 +189,7 @@ void ELORankFree(ELORank** that) {
     ELOEntityFree(&ent);
   }
   // Free memory
+  free((*that)->_index);
   free(*that);
   // Set the pointer to null
   *that = NULL;
@@ -50,11 +200,208 @@ void ELOEntityFree(ELOEntity** that) {
   // Check the argument
   if (that == NULL || *that == NULL) return;
   // Free memory
+  free((*that)->_history);
   free(*that);
   // Set the pointer to null
   *that = NULL;  
 }
 
+// Convert the sort value 'key' of an entity in 'that' into its ELO at 
+// time 't'
+static float ELORankKeyToELO(const ELORank* const that, const float key,
+  const long t) {
+  // If there is no decay the sort value is the ELO
+  if (that->_decay <= 0.0)
+    return key;
+  return ELORANK_STARTELO + (key - ELORANK_STARTELO) * 
+    exp(-1.0 * that->_decay * (double)(t - that->_decayEpoch));
+}
+
+// Convert the ELO 'elo' at time 't' of an entity in 'that' into its 
+// sort value
+static float ELORankELOToKey(const ELORank* const that, const float elo,
+  const long t) {
+  // If there is no decay the sort value is the ELO
+  if (that->_decay <= 0.0)
+    return elo;
+  return ELORANK_STARTELO + (elo - ELORANK_STARTELO) * 
+    exp(that->_decay * (double)(t - that->_decayEpoch));
+}
+
+// Carry the sort values of the entities in 'that' to the current time
+// The conversion is monotonic so the set doesn't need to be sorted
+static void ELORankRebaseDecay(ELORank* const that) {
+  GSetElem* elem = that->_set._head;
+  while (elem != NULL) {
+    elem->_sortVal = ELORankKeyToELO(that, elem->_sortVal, that->_time);
+    elem = elem->_next;
+  }
+  that->_decayEpoch = that->_time;
+}
+
+// Set the decay rate of 'that' to 'decay' (>= 0.0)
+// The ELO of the entities decays exponentially toward ELORANK_STARTELO
+// according to the time elapsed since their last activity: 
+// elo(t) = start + (elo(last) - start) * exp(-decay * (t - last))
+void ELORankSetDecay(ELORank* const that, const float decay) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (decay < 0.0) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'decay' is invalid (%f>=0.0)", decay);
+    PBErrCatch(ELORankErr);
+  }
+  if (that->_parent != NULL) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "Can't set the decay of a fork");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Convert the sort values into the ELO at current time with the 
+  // current decay, they are then valid sort values for the new decay
+  ELORankRebaseDecay(that);
+  // Set the decay
+  that->_decay = decay;
+}
+
+// Set the current time of 'that' to 't'
+// The time can't go backward
+// The ELO of the entities is not updated here, it is calculated when 
+// needed from their sort value. Only the sort values of milestones,
+// whose ELO is blocked, are corrected, and all the sort values when 
+// they are rebased on the current time.
+void ELORankSetTime(ELORank* const that, const long t) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (t < that->_time) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'t' is invalid (%ld>=%ld)", t, 
+      that->_time);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // If there is no decay or the time doesn't change
+  if (that->_decay <= 0.0 || t == that->_time) {
+    // Simply update the time
+    that->_time = t;
+    return;
+  }
+  // If 'that' is a fork, copy the milestones of its parents as they
+  // are going to be modified
+  for (const ELORank* parent = that->_parent; parent != NULL;
+    parent = parent->_parent) {
+    GSetElem* milestone = parent->_milestones._head;
+    while (milestone != NULL) {
+      GSetElem* elem = (GSetElem*)(milestone->_data);
+      ELOEntity* ent = (ELOEntity*)(elem->_data);
+      if (!ELORankIsHidden(that, parent, ent->_data))
+        (void)ELORankGetOwnElem(that, ent->_data);
+      milestone = milestone->_next;
+    }
+  }
+  // Memorise the previous time and update the time
+  long prevTime = that->_time;
+  that->_time = t;
+  // If the sort values become too large, rebase them on the current 
+  // time. This happens only every ELORANK_DECAYREBASE / decay units
+  // of time
+  bool flagRebase = 
+    (that->_decay * (double)(t - that->_decayEpoch) > 
+    ELORANK_DECAYREBASE);
+  if (flagRebase) {
+    // Correct the sort value of milestones to keep their ELO unchanged
+    // and rebase the other entities
+    GSetElem* elem = that->_set._head;
+    while (elem != NULL) {
+      if (((ELOEntity*)(elem->_data))->_isMilestone)
+        elem->_sortVal = ELORankKeyToELO(that, elem->_sortVal, prevTime);
+      else
+        elem->_sortVal = ELORankKeyToELO(that, elem->_sortVal, t);
+      elem = elem->_next;
+    }
+    that->_decayEpoch = t;
+    // If some milestones have been corrected, sort the ELORank
+    if (GSetNbElem(&(that->_milestones)) > 0)
+      GSetSort(&(that->_set));
+  } else {
+    // Correct the sort value of milestones to keep their ELO unchanged
+    // and move them one by one to their new position, the set being 
+    // sorted before each move
+    GSetElem* milestone = that->_milestones._head;
+    while (milestone != NULL) {
+      GSetElem* elem = (GSetElem*)(milestone->_data);
+      float elo = ELORankKeyToELO(that, elem->_sortVal, prevTime);
+      elem->_sortVal = ELORankELOToKey(that, elo, t);
+      ELORankMoveElem(&(that->_set), elem);
+      milestone = milestone->_next;
+    }
+  }
+}
+
+// Move the element 'elem' of 'set' to its position according to its 
+// sort value, the other elements being sorted
+// Elements with equal sort values are left in their current order
+static void ELORankMoveElem(GSet* const set, GSetElem* const elem) {
+  // Search the elements between which 'elem' must be, starting from 
+  // its current position
+  GSetElem* prev = elem->_prev;
+  GSetElem* next = elem->_next;
+  if (next != NULL && next->_sortVal < elem->_sortVal) {
+    while (next != NULL && next->_sortVal < elem->_sortVal) {
+      prev = next;
+      next = next->_next;
+    }
+  } else if (prev != NULL && prev->_sortVal > elem->_sortVal) {
+    while (prev != NULL && prev->_sortVal > elem->_sortVal) {
+      next = prev;
+      prev = prev->_prev;
+    }
+  } else {
+    // The element is already at its position
+    return;
+  }
+  // Unlink the element
+  if (elem->_prev != NULL)
+    elem->_prev->_next = elem->_next;
+  else
+    set->_head = elem->_next;
+  if (elem->_next != NULL)
+    elem->_next->_prev = elem->_prev;
+  else
+    set->_tail = elem->_prev;
+  // Link it between 'prev' and 'next'
+  elem->_prev = prev;
+  elem->_next = next;
+  if (prev != NULL)
+    prev->_next = elem;
+  else
+    set->_head = elem;
+  if (next != NULL)
+    next->_prev = elem;
+  else
+    set->_tail = elem;
+}
+
+// Remove the element 'elem' of 'that'->_set from 'that'->_milestones
+static void ELORankRemoveMilestone(ELORank* const that, 
+  const GSetElem* const elem) {
+  GSetElem* milestone = that->_milestones._head;
+  while (milestone != NULL && milestone->_data != elem)
+    milestone = milestone->_next;
+  if (milestone != NULL)
+    GSetRemoveElem(&(that->_milestones), &milestone);
+}
+
 // Add the entity 'data' to 'that' 
 void ELORankAdd(ELORank* const that, void* const data) {
 #if BUILDMODE == 0
@@ -69,11 +416,17 @@ void ELORankAdd(ELORank* const that, void* const data) {
     sprintf(ELORankErr->_msg, "'data' is null");
     PBErrCatch(ELORankErr);
   }
+  if (that->_parent != NULL) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "Can't add entities to a fork");
+    PBErrCatch(ELORankErr);
+  }
 #endif
   // Create a new ELOEntity
   ELOEntity *ent = ELOEntityCreate(data);
+  ent->_lastActivity = that->_time;
   // Add the new entity to the set with a default score
-  GSetAddSort(&(that->_set), ent, ELORANK_STARTELO);
+  (void)ELORankAddElem(that, ent, ELORANK_STARTELO);
 }
 
 // Create a new ELOEntity
@@ -93,6 +446,8 @@ static ELOEntity* ELOEntityCreate(void* const data) {
   that->_nbRun = 0;
   that->_sumSoftElo = 0.0;
   that->_isMilestone = false;
+  that->_lastActivity = 0;
+  that->_history = NULL;
   // Return the new ELOEntity
   return that;
 }
@@ -111,11 +466,21 @@ void ELORankRemove(ELORank* const that, void* data) {
     sprintf(ELORankErr->_msg, "'data' is null");
     PBErrCatch(ELORankErr);
   }
+  if (that->_parent != NULL) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "Can't remove entities from a fork");
+    PBErrCatch(ELORankErr);
+  }
 #endif
   // Search the entity
-  GSetElem* elem = ELORankGetElem(that, data);
+  GSetElem* elem = ELORankGetSetElem(that, data);
   // If we have found the entity
   if (elem != NULL) {
+    // Remove it from the index
+    ELORankRemoveIndex(that, data);
+    // Remove it from the milestones
+    if (((ELOEntity*)(elem->_data))->_isMilestone)
+      ELORankRemoveMilestone(that, elem);
     // Free the memory 
     ELOEntityFree((ELOEntity**)(&(elem->_data)));
     // Remove the element
@@ -123,8 +488,109 @@ void ELORankRemove(ELORank* const that, void* data) {
   }
 }
 
-// Return the GSetElem in 'that'->_set for the entity 'data'
-static GSetElem* ELORankGetElem(const ELORank* const that, const void* const data) {
+// Return the GSetElem in 'that'->_set for the entity 'data', without
+// searching in the parents of 'that'
+static GSetElem* ELORankGetSetElem(const ELORank* const that, 
+  const void* const data) {
+  // If the index is empty there is no element
+  if (that->_nbIndex == 0)
+    return NULL;
+  // Search the element in the index
+  return that->_index[ELORankGetIndexPos(that, data)];
+}
+
+// Return the position in the index of 'that' of the entity 'data' if 
+// it's in 'that'->_set, or of the empty entry where it would be added
+// else
+static unsigned long ELORankGetIndexPos(const ELORank* const that,
+  const void* const data) {
+  unsigned long mask = that->_nbIndex - 1;
+  unsigned long h = (uintptr_t)data * 0x9E3779B97F4A7C15UL;
+  unsigned long pos = (h ^ (h >> 29)) & mask;
+  // Linear probing
+  while (that->_index[pos] != NULL &&
+    ((ELOEntity*)(that->_index[pos]->_data))->_data != data)
+    pos = (pos + 1) & mask;
+  return pos;
+}
+
+// Add the entity 'ent' to 'that'->_set with the sort value 'key' and
+// to the index of 'that'
+// Return the new element
+static GSetElem* ELORankAddElem(ELORank* const that, 
+  ELOEntity* const ent, const float key) {
+  // Append the entity to the set and link its element at its sorted 
+  // position, after the elements of equal sort value as GSetAddSort
+  GSetAppend(&(that->_set), ent);
+  GSetElem* elem = that->_set._tail;
+  elem->_sortVal = key;
+  ELORankMoveElem(&(that->_set), elem);
+  // If the index is more than half full, double its size
+  if (2 * (unsigned long)GSetNbElem(&(that->_set)) > that->_nbIndex) {
+    GSetElem** index = that->_index;
+    unsigned long nbIndex = that->_nbIndex;
+    that->_nbIndex = (nbIndex == 0 ? 16 : 2 * nbIndex);
+    that->_index = 
+      PBErrMalloc(ELORankErr, sizeof(GSetElem*) * that->_nbIndex);
+    for (unsigned long pos = that->_nbIndex; pos--;)
+      that->_index[pos] = NULL;
+    for (unsigned long pos = nbIndex; pos--;)
+      if (index[pos] != NULL)
+        that->_index[ELORankGetIndexPos(that, 
+          ((ELOEntity*)(index[pos]->_data))->_data)] = index[pos];
+    free(index);
+  }
+  // Add the element to the index
+  that->_index[ELORankGetIndexPos(that, ent->_data)] = elem;
+  // Return the new element
+  return elem;
+}
+
+// Remove the entity 'data' from the index of 'that'
+// The following entries are shifted backward to keep the probing
+// sequences valid
+static void ELORankRemoveIndex(ELORank* const that, 
+  const void* const data) {
+  unsigned long mask = that->_nbIndex - 1;
+  unsigned long pos = ELORankGetIndexPos(that, data);
+  that->_index[pos] = NULL;
+  unsigned long next = (pos + 1) & mask;
+  while (that->_index[next] != NULL) {
+    // Get the position where the entry at 'next' would be without
+    // collision
+    unsigned long h = (uintptr_t)
+      (((ELOEntity*)(that->_index[next]->_data))->_data) * 
+      0x9E3779B97F4A7C15UL;
+    unsigned long home = (h ^ (h >> 29)) & mask;
+    // If this position is not in ]pos, next], move the entry to the
+    // empty entry
+    bool inRange = (pos < next ?
+      (home > pos && home <= next) : (home > pos || home <= next));
+    if (!inRange) {
+      that->_index[pos] = that->_index[next];
+      that->_index[next] = NULL;
+      pos = next;
+    }
+    next = (next + 1) & mask;
+  }
+}
+
+// Return true if the element for the entity 'data' in 'owner', a 
+// parent of 'that', is hidden by a copy in 'that' or one of the 
+// parents between 'that' and 'owner'
+static bool ELORankIsHidden(const ELORank* const that, 
+  const ELORank* const owner, const void* const data) {
+  for (const ELORank* rank = that; rank != owner; rank = rank->_parent)
+    if (ELORankGetSetElem(rank, data) != NULL)
+      return true;
+  return false;
+}
+
+// Return the GSetElem for the entity 'data' as seen from 'that', i.e. 
+// searching in 'that'->_set and then in the parents of 'that'
+// If 'owner' is not null it's set to the ELORank holding the element
+static GSetElem* ELORankGetElem(const ELORank* const that, 
+  const void* const data, const ELORank** const owner) {
 #if BUILDMODE == 0
   // Check arguments
   if (that == NULL) {
@@ -138,14 +604,164 @@ static GSetElem* ELORankGetElem(const ELORank* const that, const void* const dat
     PBErrCatch(ELORankErr);
   }
 #endif
+  // Search the element in 'that' and its parents
+  const ELORank* rank = that;
+  GSetElem* elem = NULL;
+  while (rank != NULL && elem == NULL) {
+    elem = ELORankGetSetElem(rank, data);
+    if (elem == NULL)
+      rank = rank->_parent;
+  }
+  if (owner != NULL)
+    *owner = rank;
+  // Return the element
+  return elem;
+}
+
+// Return the GSetElem in 'that'->_set for the entity 'data', copying
+// it from the parents of 'that' if necessary (copy-on-write)
+static GSetElem* ELORankGetOwnElem(ELORank* const that, 
+  const void* const data) {
   // Search the element
-  GSetElem* elem = that->_set._head;
-  while (elem != NULL && ((ELOEntity*)(elem->_data))->_data != data)
-    elem = elem->_next;
+  const ELORank* owner = NULL;
+  GSetElem* elem = ELORankGetElem(that, data, &owner);
+  // If the element belongs to a parent
+  if (elem != NULL && owner != that) {
+    // Copy the entity
+    ELOEntity* ent = PBErrMalloc(ELORankErr, sizeof(ELOEntity));
+    memcpy(ent, elem->_data, sizeof(ELOEntity));
+    if (ent->_history != NULL)
+      ent->_history = ELOHistoryClone(ent->_history);
+    // Add it to 'that' with its current ELO
+    float elo = ELORankKeyToELO(owner, elem->_sortVal, that->_time);
+    elem = ELORankAddElem(that, ent, 
+      ELORankELOToKey(that, elo, that->_time));
+    // The copy of a milestone is a milestone of 'that'
+    if (ent->_isMilestone)
+      GSetAppend(&(that->_milestones), elem);
+  }
   // Return the element
   return elem;
 }
 
+// Return the 'rank'-th element (if 'data' is null) or the element for
+// the entity 'data' (else) according to current ELO as seen from 'that'
+// If 'pos' is not null it's set to the rank of the returned element
+// The sets of 'that' and its parents are merged on the fly, skipping
+// the elements of parents which have been copied in a fork (checked in
+// the index of the forks)
+static GSetElem* ELORankWalk(const ELORank* const that, const int rank,
+  const void* const data, int* const pos) {
+  // Get the number of sets to merge
+  int nbSet = 0;
+  for (const ELORank* r = that; r != NULL; r = r->_parent)
+    ++nbSet;
+  // Declare variables to memorise the owner of each set and the 
+  // current element in each set, starting from the highest ELO
+  const ELORank* owners[nbSet];
+  GSetElem* elems[nbSet];
+  int iSet = 0;
+  for (const ELORank* r = that; r != NULL; r = r->_parent) {
+    owners[iSet] = r;
+    elems[iSet] = r->_set._tail;
+    ++iSet;
+  }
+  // Loop on the merged elements
+  int iPos = 0;
+  while (true) {
+    // Search the visible element with highest ELO among the current
+    // elements
+    int iBest = -1;
+    float bestELO = 0.0;
+    for (iSet = 0; iSet < nbSet; ++iSet) {
+      // Skip the elements hidden by a copy in a fork
+      while (elems[iSet] != NULL && iSet > 0 &&
+        ELORankIsHidden(that, owners[iSet], 
+        ((ELOEntity*)(elems[iSet]->_data))->_data))
+        elems[iSet] = elems[iSet]->_prev;
+      if (elems[iSet] != NULL) {
+        // If there is only one set there is nothing to merge
+        float elo = (nbSet == 1 ? 0.0 : ELORankKeyToELO(owners[iSet], 
+          elems[iSet]->_sortVal, that->_time));
+        if (iBest == -1 || elo > bestELO) {
+          iBest = iSet;
+          bestELO = elo;
+        }
+      }
+    }
+    // If there is no more element, stop here
+    if (iBest == -1)
+      return NULL;
+    // If it's the requested element, return it
+    GSetElem* elem = elems[iBest];
+    if ((data == NULL && iPos == rank) || 
+      (data != NULL && ((ELOEntity*)(elem->_data))->_data == data)) {
+      if (pos != NULL)
+        *pos = iPos;
+      return elem;
+    }
+    // Move to the next element
+    elems[iBest] = elem->_prev;
+    ++iPos;
+  }
+}
+
+// Apply the results 'res' to the entities of 'that' without sorting 
+// the set of entities (cf ELORankUpdate)
+static void ELORankApplyResult(ELORank* const that, 
+  const GSet* const res) {
+  // Get the element of each entity, copying it if 'that' is a fork,
+  // its current ELO and its score
+  int nb = GSetNbElem(res);
+  GSetElem* elemElos[nb];
+  float elos[nb];
+  float scores[nb];
+  float deltaElo[nb];
+  GSetElem* elem = res->_head;
+  for (int iElem = 0; iElem < nb; ++iElem) {
+    elemElos[iElem] = ELORankGetOwnElem(that, elem->_data);
+#if BUILDMODE == 0
+    if (elemElos[iElem] == NULL) {
+      ELORankErr->_type = PBErrTypeNullPointer;
+      sprintf(ELORankErr->_msg, 
+        "Entity in the result set can't be found in the ELORank.");
+      PBErrCatch(ELORankErr);
+    }
+#endif
+    elos[iElem] = 
+      ELORankKeyToELO(that, elemElos[iElem]->_sortVal, that->_time);
+    scores[iElem] = elem->_sortVal;
+    deltaElo[iElem] = 0.0;
+    elem = elem->_next;
+  }
+  // Calculate the delta of elo of each entity (there is none if there
+  // is less than two entities)
+  if (nb >= 2)
+    ELORankAddDeltaELO(that->_k, nb, elos, scores, deltaElo);
+  // Apply the delta of elo and update the number of run
+  for (int iElem = 0; iElem < nb; ++iElem) {
+    GSetElem* elemElo = elemElos[iElem];
+    ELOEntity* ent = (ELOEntity*)(elemElo->_data);
+    // Get the ELO of the entity at current time
+    float elo = elos[iElem];
+    // If the entity is a milestone, its elo is blocked to its current
+    // value
+    if (!(ent->_isMilestone)) {
+      elo += deltaElo[iElem];
+      elemElo->_sortVal = ELORankELOToKey(that, elo, that->_time);
+    }
+    ent->_lastActivity = that->_time;
+    ++(ent->_nbRun);
+    if (ent->_nbRun >= 100) {
+      ent->_sumSoftElo *= 0.99;
+    }
+    ent->_sumSoftElo += elo;
+    if (ent->_history != NULL)
+      ELOHistoryPush(ent->_history, that->_nbMatch, elo);
+  }
+  ++(that->_nbMatch);
+}
+
 // Update the ranks in 'that' with results 'res' given as a GSet of 
 // pointers toward entities (_data in GSetElem equals _data in 
 // ELOEntity) in winning order
@@ -174,84 +790,110 @@ void ELORankUpdate(ELORank* const that, const GSet* const res) {
     PBErrCatch(ELORankErr);
   }
 #endif
-  // Declare a variable to memorise the delta of elo of each entity
-  VecFloat* deltaElo = VecFloatCreate(GSetNbElem(res));
-  // Calculate the delta of elo for each pair of entity
-  GSetElem* elemA = res->_head;
-  int iElem = 0;
-  while (elemA != NULL) {
-    GSetElem* elemAElo = ELORankGetElem(that, elemA->_data);
+  // Apply the results
+  ELORankApplyResult(that, res);
+  // Sort the ELORank
+  GSetSort(&(that->_set));
+}
+
+// Update the ranks in 'that' with the 'nb' results 'res', applied in 
+// the order of the array as if ELORankUpdate was called on each of them
+// but the entities are sorted only once after the last result
+void ELORankUpdateBatch(ELORank* const that, const int nb, 
+  const GSet* const* const res) {
 #if BUILDMODE == 0
-    if (elemAElo == NULL) {
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (nb < 0) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'nb' is invalid (%d>=0)", nb);
+    PBErrCatch(ELORankErr);
+  }
+  if (nb > 0 && res == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'res' is null");
+    PBErrCatch(ELORankErr);
+  }
+  for (int iRes = nb; iRes--;) {
+    if (res[iRes] == NULL) {
       ELORankErr->_type = PBErrTypeNullPointer;
+      sprintf(ELORankErr->_msg, "'res[%d]' is null", iRes);
+      PBErrCatch(ELORankErr);
+    }
+    if (GSetNbElem(res[iRes]) < 2) {
+      ELORankErr->_type = PBErrTypeInvalidArg;
       sprintf(ELORankErr->_msg, 
-        "Entity in the result set can't be found in the ELORank.");
+        "Number of elements in result set %d invalid (%ld>=2)",
+        iRes, GSetNbElem(res[iRes]));
       PBErrCatch(ELORankErr);
     }
+  }
 #endif
-    GSetElem* elemB = res->_head;
-    while (elemB != NULL) {
-      // Ignore tie and match with itself
-      if (ISEQUALF(elemA->_sortVal, elemB->_sortVal) == false) {
-        GSetElem* elemBElo = ELORankGetElem(that, elemB->_data);
-#if BUILDMODE == 0
-        if (elemBElo == NULL) {
-          ELORankErr->_type = PBErrTypeNullPointer;
-          sprintf(ELORankErr->_msg, 
-            "Entity in the result set can't be found in the ELORank.");
-          PBErrCatch(ELORankErr);
-        }
+  // If there is no result, nothing to do
+  if (nb == 0)
+    return;
+  // Apply the results in order
+  // The ELO of the entities are read from their element whatever the
+  // order of the set, so the set doesn't need to be sorted between
+  // two results
+  for (int iRes = 0; iRes < nb; ++iRes)
+    ELORankApplyResult(that, res[iRes]);
+  // Sort the ELORank
+  GSetSort(&(that->_set));
+}
+
+// Add to 'deltas' the variation of ELO of the 'nb' entities whose 
+// current ELO are 'elos' and scores in an evaluation are 'scores' 
+// (higher is better, equal means tie), for the ELO coefficient 'k'
+// This is the calculation used by ELORankUpdate
+void ELORankAddDeltaELO(const float k, const int nb, 
+  const float* const elos, const float* const scores, 
+  float* const deltas) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (elos == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'elos' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (scores == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'scores' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (deltas == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'deltas' is null");
+    PBErrCatch(ELORankErr);
+  }
 #endif
-        // If elemA has won
-        if (elemA->_sortVal > elemB->_sortVal) {
-          float winnerELO = elemAElo->_sortVal;
-          float looserELO = elemBElo->_sortVal;
+  // Calculate the delta of elo for each pair of entity
+  for (int iA = 0; iA < nb; ++iA) {
+    for (int iB = 0; iB < nb; ++iB) {
+      // Ignore tie and match with itself
+      if (ISEQUALF(scores[iA], scores[iB]) == false) {
+        // If A has won
+        if (scores[iA] > scores[iB]) {
+          float winnerELO = elos[iA];
+          float looserELO = elos[iB];
           float a = 
             1.0 / (1.0 + pow(10.0, (looserELO - winnerELO) / 400.0));
-          VecSetAdd(deltaElo, iElem, that->_k * (1.0 - a));
-        // Else, if elemA has lost
+          deltas[iA] += k * (1.0 - a);
+        // Else, if A has lost
         } else {
-          float winnerELO = elemBElo->_sortVal;
-          float looserELO = elemAElo->_sortVal;
+          float winnerELO = elos[iB];
+          float looserELO = elos[iA];
           float b = 
             1.0 / (1.0 + pow(10.0, (winnerELO - looserELO) / 400.0));
-          VecSetAdd(deltaElo, iElem, -1.0 * that->_k * b);
+          deltas[iA] += -1.0 * k * b;
         }
       }
-      elemB = elemB->_next;
-    }
-    elemA = elemA->_next;
-    ++iElem;
-  }
-  // Apply the delta of elo and update the number of run
-  GSetElem* elem = res->_head;
-  iElem = 0;
-  while (elem != NULL) {
-    GSetElem* elemElo = ELORankGetElem(that, elem->_data);
-#if BUILDMODE == 0
-    if (elemElo == NULL) {
-      ELORankErr->_type = PBErrTypeNullPointer;
-      sprintf(ELORankErr->_msg, 
-        "Entity in the result set can't be found in the ELORank.");
-      PBErrCatch(ELORankErr);
     }
-#endif
-    // If the entity is a milestone, its elo is blocked to its current
-    // value
-    if (!(((ELOEntity*)(elemElo->_data))->_isMilestone))
-      elemElo->_sortVal += VecGet(deltaElo, iElem);
-    ++(((ELOEntity*)(elemElo->_data))->_nbRun);
-    if (((ELOEntity*)(elemElo->_data))->_nbRun >= 100) {
-      ((ELOEntity*)(elemElo->_data))->_sumSoftElo *= 0.99;
-    }
-    ((ELOEntity*)(elemElo->_data))->_sumSoftElo += elemElo->_sortVal;
-    ++iElem;
-    elem = elem->_next;
   }
-  // Free memory
-  VecFree(&deltaElo);
-  // Sort the ELORank
-  GSetSort(&(that->_set));
 }
 
 // Get the current rank of the entity 'data' (starts at 0)
@@ -272,11 +914,7 @@ int ELORankGetRank(const ELORank* const that, const void* const data) {
   // Declare a variable to memorize the rank
   int rank = 0;
   // Search the element
-  GSetElem* elem = that->_set._tail;
-  while (elem != NULL && ((ELOEntity*)(elem->_data))->_data != data) {
-    elem = elem->_prev;
-    ++rank;
-  }
+  GSetElem* elem = ELORankWalk(that, 0, data, &rank);
 #if BUILDMODE == 0
   if (elem == NULL) {
     ELORankErr->_type = PBErrTypeNullPointer;
@@ -284,6 +922,8 @@ int ELORankGetRank(const ELORank* const that, const void* const data) {
       "Entity requested can't be found in the ELORank.");
     PBErrCatch(ELORankErr);
   }
+#else
+  (void)elem;
 #endif  
   // Return the element
   return rank;
@@ -307,12 +947,10 @@ float ELORankGetELO(const ELORank* const that, const void* const data) {
   // Declare a variable to memorize the ELO
   float elo = ELORANK_STARTELO;
   // Search the element
-  GSetElem* elem = that->_set._head;
-  while (elem != NULL && ((ELOEntity*)(elem->_data))->_data != data) {
-    elem = elem->_next;
-  }
+  const ELORank* owner = NULL;
+  GSetElem* elem = ELORankGetElem(that, data, &owner);
   if (elem != NULL) {
-    elo = elem->_sortVal;
+    elo = ELORankKeyToELO(owner, elem->_sortVal, that->_time);
 #if BUILDMODE == 0
   } else {
     ELORankErr->_type = PBErrTypeNullPointer;
@@ -325,6 +963,110 @@ float ELORankGetELO(const ELORank* const that, const void* const data) {
   return elo;
 }
 
+// Get the expected scores of the 'nb' entities 'data' in 'that' 
+// against each other
+// 'mat' is an array of nb*nb floats receiving, at index i*nb+j, the
+// probability that 'data'[i] wins against 'data'[j], calculated with 
+// the same formula as ELORankUpdate: 1/(1+10^((elo_j-elo_i)/400))
+// (the diagonal is equal to 0.5)
+// If 'placement' is not null it's an array of nb floats receiving the
+// expected placement of each entity in a match between the 'nb' 
+// entities (0.0 means first place)
+// No memory is allocated on the heap
+void ELORankGetExpectedScores(const ELORank* const that, const int nb, 
+  const void* const* const data, float* const mat, 
+  float* const placement) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (data == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'data' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (mat == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'mat' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (nb < 1) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'nb' is invalid (%d>=1)", nb);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // 1/(1+10^((elo_j-elo_i)/400)) is equal to q_i/(q_i+q_j) with 
+  // q_i=10^(elo_i/400). The q_i are calculated once per entity, 
+  // relatively to the highest ELO to avoid overflow, and the kernel 
+  // is reduced to divisions on contiguous arrays which the compiler 
+  // can vectorize
+  double q[nb];
+  float eloMax = 0.0;
+  for (int i = 0; i < nb; ++i) {
+    float elo = ELORankGetELO(that, data[i]);
+    q[i] = elo;
+    if (i == 0 || elo > eloMax)
+      eloMax = elo;
+  }
+  for (int i = 0; i < nb; ++i)
+    q[i] = pow(10.0, (q[i] - eloMax) / 400.0);
+  // Calculate the expected scores and placements
+  for (int i = 0; i < nb; ++i) {
+    float* row = mat + i * nb;
+    double qi = q[i];
+    for (int j = 0; j < nb; ++j)
+      row[j] = qi / (qi + q[j]);
+    // The expected placement is the expected number of entities 
+    // winning against the entity, excluding itself (0.5)
+    if (placement != NULL) {
+      float sumWin = 0.0;
+      for (int j = 0; j < nb; ++j)
+        sumWin += row[j];
+      placement[i] = (float)nb - sumWin - 0.5;
+    }
+  }
+}
+
+// Get the expected scores of the 'nbLobby' lobbies of entities in 
+// 'that'
+// 'sizes' gives the number of entities in each lobby and 'data' the
+// entities of all the lobbies one after the other
+// 'mats' receives the matrix of expected scores of each lobby one after
+// the other (sum of sizes[i]^2 floats) and 'placements', if not null,
+// the expected placement of entities in their lobby (sum of sizes[i]
+// floats), cf ELORankGetExpectedScores
+void ELORankGetLobbiesExpectedScores(const ELORank* const that, 
+  const int nbLobby, const int* const sizes, 
+  const void* const* const data, float* const mats, 
+  float* const placements) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (sizes == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'sizes' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Loop on the lobbies
+  int iData = 0;
+  int iMat = 0;
+  for (int iLobby = 0; iLobby < nbLobby; ++iLobby) {
+    ELORankGetExpectedScores(that, sizes[iLobby], data + iData, 
+      mats + iMat, (placements != NULL ? placements + iData : NULL));
+    iData += sizes[iLobby];
+    iMat += sizes[iLobby] * sizes[iLobby];
+  }
+}
+
 // Get the current soft ELO (average of elo over nb of evaluation) 
 // of the entity 'data'
 float ELORankGetSoftELO(const ELORank* const that, 
@@ -345,10 +1087,7 @@ float ELORankGetSoftELO(const ELORank* const that,
   // Declare a variable to memorize the ELO
   float elo = ELORANK_STARTELO;
   // Search the element
-  GSetElem* elem = that->_set._head;
-  while (elem != NULL && ((ELOEntity*)(elem->_data))->_data != data) {
-    elem = elem->_next;
-  }
+  GSetElem* elem = ELORankGetElem(that, data, NULL);
   if (elem != NULL) {
     if (((ELOEntity*)(elem->_data))->_nbRun > 0) {
       elo = ((ELOEntity*)(elem->_data))->_sumSoftElo / 
@@ -366,6 +1105,40 @@ float ELORankGetSoftELO(const ELORank* const that,
   return elo;
 }
 
+// Get the time of the last activity of the entity 'data'
+long ELORankGetLastActivity(const ELORank* const that, 
+  const void* const data) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (data == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'data' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Declare a variable to memorize the time
+  long t = 0;
+  // Search the element
+  GSetElem* elem = ELORankGetElem(that, data, NULL);
+  if (elem != NULL) {
+    t = ((ELOEntity*)(elem->_data))->_lastActivity;
+#if BUILDMODE == 0
+  } else {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, 
+      "Entity requested can't be found in the ELORank.");
+    PBErrCatch(ELORankErr);
+#endif  
+  }
+  // Return the time
+  return t;
+}
+
 // Set the milestone flag of the entity 'data' to 'flag'
 void ELORankSetIsMilestone(const ELORank* const that, 
   const void* const data, const bool flag) {
@@ -382,14 +1155,17 @@ void ELORankSetIsMilestone(const ELORank* const that,
     PBErrCatch(ELORankErr);
   }
 #endif
-  // Search the element
-  GSetElem* elem = that->_set._head;
-  while (elem != NULL && ((ELOEntity*)(elem->_data))->_data != data) {
-    elem = elem->_next;
-  }
+  // Search the element, copying it if 'that' is a fork
+  GSetElem* elem = ELORankGetOwnElem((ELORank*)that, data);
   if (elem != NULL) {
+    // Update the set of milestones
+    ELOEntity* ent = (ELOEntity*)(elem->_data);
+    if (flag && !(ent->_isMilestone))
+      GSetAppend((GSet*)&(that->_milestones), elem);
+    else if (!flag && ent->_isMilestone)
+      ELORankRemoveMilestone((ELORank*)that, elem);
     // Set the flag 
-    ((ELOEntity*)(elem->_data))->_isMilestone = flag;
+    ent->_isMilestone = flag;
 #if BUILDMODE == 0
   } else {
     ELORankErr->_type = PBErrTypeNullPointer;
@@ -410,11 +1186,25 @@ void ELORankResetAllMilestone(const ELORank* const that) {
     PBErrCatch(ELORankErr);
   }
 #endif
-  // Search the element
-  GSetElem* elem = that->_set._head;
-  while (elem != NULL) {
+  // If 'that' is a fork, copy the milestones of its parents, they are
+  // added to the milestones of 'that'
+  for (const ELORank* parent = that->_parent; parent != NULL;
+    parent = parent->_parent) {
+    GSetElem* milestone = parent->_milestones._head;
+    while (milestone != NULL) {
+      GSetElem* elem = (GSetElem*)(milestone->_data);
+      ELOEntity* ent = (ELOEntity*)(elem->_data);
+      if (!ELORankIsHidden(that, parent, ent->_data))
+        (void)ELORankGetOwnElem((ELORank*)that, ent->_data);
+      milestone = milestone->_next;
+    }
+  }
+  // Reset the flag of the milestones of 'that' and empty the set of 
+  // milestones
+  GSet* milestones = (GSet*)&(that->_milestones);
+  while (GSetNbElem(milestones) > 0) {
+    GSetElem* elem = GSetPop(milestones);
     ((ELOEntity*)(elem->_data))->_isMilestone = false;
-    elem = elem->_next;
   }
 }
 
@@ -434,14 +1224,14 @@ void ELORankSetELO(const ELORank* const that, const void* const data,
     PBErrCatch(ELORankErr);
   }
 #endif
-  // Search the element
-  GSetElem* elem = that->_set._head;
-  while (elem != NULL && ((ELOEntity*)(elem->_data))->_data != data) {
-    elem = elem->_next;
-  }
+  // Search the element, copying it if 'that' is a fork
+  GSetElem* elem = ELORankGetOwnElem((ELORank*)that, data);
   if (elem != NULL) {
     // Set the elo
-    elem->_sortVal = elo;
+    elem->_sortVal = ELORankELOToKey(that, elo, that->_time);
+    ((ELOEntity*)(elem->_data))->_lastActivity = that->_time;
+    // Move the element to its new rank
+    ELORankMoveElem((GSet*)&(that->_set), elem);
 #if BUILDMODE == 0
   } else {
     ELORankErr->_type = PBErrTypeNullPointer;
@@ -450,8 +1240,6 @@ void ELORankSetELO(const ELORank* const that, const void* const data,
     PBErrCatch(ELORankErr);
 #endif  
   }
-  // Sort the ELORank
-  GSetSort((GSet*)&(that->_set));
 }
 
 // Reset the current ELO of the entity 'data'
@@ -469,16 +1257,16 @@ void ELORankResetELO(const ELORank* const that, const void* const data) {
     PBErrCatch(ELORankErr);
   }
 #endif
-  // Search the element
-  GSetElem* elem = that->_set._head;
-  while (elem != NULL && ((ELOEntity*)(elem->_data))->_data != data) {
-    elem = elem->_next;
-  }
+  // Search the element, copying it if 'that' is a fork
+  GSetElem* elem = ELORankGetOwnElem((ELORank*)that, data);
   if (elem != NULL) {
     // Reset the elo, nbRun and sumSoftElo
     elem->_sortVal = ELORANK_STARTELO;
     ((ELOEntity*)(elem->_data))->_sumSoftElo = 0.0;
     ((ELOEntity*)(elem->_data))->_nbRun = 0;
+    ((ELOEntity*)(elem->_data))->_lastActivity = that->_time;
+    // Move the element to its new rank
+    ELORankMoveElem((GSet*)&(that->_set), elem);
 #if BUILDMODE == 0
   } else {
     ELORankErr->_type = PBErrTypeNullPointer;
@@ -487,8 +1275,172 @@ void ELORankResetELO(const ELORank* const that, const void* const data) {
     PBErrCatch(ELORankErr);
 #endif  
   }
-  // Sort the ELORank
-  GSetSort((GSet*)&(that->_set));
+}
+
+// Set the size in bytes of the history of the entity 'data' to 'size'
+// (0 to disable the history, else at least ELORANK_HISTORYMINSIZE)
+// When enabled, a sample (match index, ELO after the match) is added
+// to the history at each update of the entity, the oldest samples 
+// being dropped when the history is full. A sample uses usually 2 to 4
+// bytes. The history is disabled by default.
+void ELORankSetHistorySize(const ELORank* const that, 
+  const void* const data, const int size) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (data == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'data' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (size != 0 && size < ELORANK_HISTORYMINSIZE) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'size' is invalid (%d==0 || %d>=%d)", 
+      size, size, ELORANK_HISTORYMINSIZE);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Search the element, copying it if 'that' is a fork
+  GSetElem* elem = ELORankGetOwnElem((ELORank*)that, data);
+  if (elem != NULL) {
+    ELOEntity* ent = (ELOEntity*)(elem->_data);
+    // Resize the history
+    if (ent->_history != NULL)
+      ent->_history = ELOHistoryResize(ent->_history, size);
+    else if (size > 0)
+      ent->_history = ELOHistoryCreate(size);
+#if BUILDMODE == 0
+  } else {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, 
+      "Entity requested can't be found in the ELORank.");
+    PBErrCatch(ELORankErr);
+#endif  
+  }
+}
+
+// Get the size in bytes of the history of the entity 'data' (0 if the
+// history is disabled)
+int ELORankGetHistorySize(const ELORank* const that, 
+  const void* const data) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (data == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'data' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Declare a variable to memorize the size
+  int size = 0;
+  // Search the element
+  GSetElem* elem = ELORankGetElem(that, data, NULL);
+  if (elem != NULL) {
+    const ELOHistory* history = ((ELOEntity*)(elem->_data))->_history;
+    if (history != NULL)
+      size = history->_capacity;
+#if BUILDMODE == 0
+  } else {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, 
+      "Entity requested can't be found in the ELORank.");
+    PBErrCatch(ELORankErr);
+#endif  
+  }
+  // Return the size
+  return size;
+}
+
+// Get the number of samples in the history of the entity 'data'
+int ELORankGetHistoryNb(const ELORank* const that, 
+  const void* const data) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (data == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'data' is null");
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Declare a variable to memorize the number of samples
+  int nb = 0;
+  // Search the element
+  GSetElem* elem = ELORankGetElem(that, data, NULL);
+  if (elem != NULL) {
+    const ELOHistory* history = ((ELOEntity*)(elem->_data))->_history;
+    if (history != NULL)
+      nb = history->_nb;
+#if BUILDMODE == 0
+  } else {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, 
+      "Entity requested can't be found in the ELORank.");
+    PBErrCatch(ELORankErr);
+#endif  
+  }
+  // Return the number of samples
+  return nb;
+}
+
+// Get the 'nb' most recent samples of the history of the entity 'data'
+// 'matches' and 'elos' (which can be null) are arrays of 'nb' 
+// elements receiving the match index and ELO (rounded to 
+// ELORANK_HISTORYRESOLUTION) of the samples from the oldest to the 
+// most recent
+// Return the number of samples copied (less than 'nb' if the history
+// contains less samples)
+int ELORankGetHistory(const ELORank* const that, const void* const data,
+  const int nb, long* const matches, float* const elos) {
+#if BUILDMODE == 0
+  // Check arguments
+  if (that == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'that' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (data == NULL) {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, "'data' is null");
+    PBErrCatch(ELORankErr);
+  }
+  if (nb < 0) {
+    ELORankErr->_type = PBErrTypeInvalidArg;
+    sprintf(ELORankErr->_msg, "'nb' is invalid (%d>=0)", nb);
+    PBErrCatch(ELORankErr);
+  }
+#endif
+  // Declare a variable to memorize the number of samples copied
+  int nbCopy = 0;
+  // Search the element
+  GSetElem* elem = ELORankGetElem(that, data, NULL);
+  if (elem != NULL) {
+    const ELOHistory* history = ((ELOEntity*)(elem->_data))->_history;
+    if (history != NULL)
+      nbCopy = ELOHistoryGet(history, nb, matches, elos);
+#if BUILDMODE == 0
+  } else {
+    ELORankErr->_type = PBErrTypeNullPointer;
+    sprintf(ELORankErr->_msg, 
+      "Entity requested can't be found in the ELORank.");
+    PBErrCatch(ELORankErr);
+#endif  
+  }
+  // Return the number of samples copied
+  return nbCopy;
 }
 
 // Get the 'rank'-th entity according to current ELO of 'that'  
@@ -501,15 +1453,170 @@ const ELOEntity* ELORankGetRanked(const ELORank* const that, const int rank) {
     sprintf(ELORankErr->_msg, "'that' is null");
     PBErrCatch(ELORankErr);
   }
-  if (rank < 0 || rank >= GSetNbElem(&(that->_set))) {
+  if (rank < 0 || rank >= ELORankGetNb(that)) {
     ELORankErr->_type = PBErrTypeInvalidArg;
-    sprintf(ELORankErr->_msg, "'rank' is invalid (0<=%d<%ld)", rank, 
-      GSetNbElem(&(that->_set)));
+    sprintf(ELORankErr->_msg, "'rank' is invalid (0<=%d<%d)", rank, 
+      ELORankGetNb(that));
     PBErrCatch(ELORankErr);
   }
 #endif
-  GSetElem* elem = that->_set._tail;
-  for (int i = rank; i--;)
-    elem = elem->_prev;
+  GSetElem* elem = ELORankWalk(that, rank, NULL, NULL);
   return (ELOEntity*)(elem->_data);
 }
+
+// Create a new empty ELOHistory of 'capacity' bytes
+static ELOHistory* ELOHistoryCreate(const int capacity) {
+  // Allocate memory
+  ELOHistory* that = 
+    PBErrMalloc(ELORankErr, sizeof(ELOHistory) + capacity);
+  // Set properties
+  that->_capacity = capacity;
+  that->_head = 0;
+  that->_size = 0;
+  that->_nb = 0;
+  that->_firstMatch = 0;
+  that->_firstElo = 0;
+  that->_lastMatch = 0;
+  that->_lastElo = 0;
+  // Return the new ELOHistory
+  return that;
+}
+
+// Return a copy of the ELOHistory 'that'
+static ELOHistory* ELOHistoryClone(const ELOHistory* const that) {
+  ELOHistory* clone = 
+    PBErrMalloc(ELORankErr, sizeof(ELOHistory) + that->_capacity);
+  memcpy(clone, that, sizeof(ELOHistory) + that->_capacity);
+  return clone;
+}
+
+// Return the ELOHistory 'that' resized to 'capacity' bytes, keeping its
+// most recent samples, or NULL if 'capacity' is 0
+// 'that' is freed
+static ELOHistory* ELOHistoryResize(ELOHistory* const that, 
+  const int capacity) {
+  ELOHistory* history = NULL;
+  if (capacity > 0) {
+    // Copy the samples into the new history, which drops the oldest 
+    // ones if it's smaller
+    history = ELOHistoryCreate(capacity);
+    long* matches = PBErrMalloc(ELORankErr, sizeof(long) * that->_nb);
+    float* elos = PBErrMalloc(ELORankErr, sizeof(float) * that->_nb);
+    int nb = ELOHistoryGet(that, that->_nb, matches, elos);
+    for (int iSample = 0; iSample < nb; ++iSample)
+      ELOHistoryPush(history, matches[iSample], elos[iSample]);
+    free(elos);
+    free(matches);
+  }
+  free(that);
+  return history;
+}
+
+// Add the sample ('match', 'elo') at the end of the ELOHistory 'that'
+static void ELOHistoryPush(ELOHistory* const that, const long match,
+  const float elo) {
+  long q = lround(elo / ELORANK_HISTORYRESOLUTION);
+  // If the history is empty the sample is stored as is
+  if (that->_nb == 0) {
+    that->_firstMatch = that->_lastMatch = match;
+    that->_firstElo = that->_lastElo = q;
+    that->_nb = 1;
+    return;
+  }
+  // Encode the variation from the most recent sample, the variation of
+  // ELO is zigzag encoded to keep small negative values short
+  unsigned char bytes[ELORANK_HISTORYMINSIZE];
+  long deltaElo = q - that->_lastElo;
+  int nbByte = ELOHistoryWrite(match - that->_lastMatch, bytes);
+  nbByte += ELOHistoryWrite(((unsigned long)deltaElo << 1) ^ 
+    (unsigned long)(deltaElo >> (8 * sizeof(long) - 1)), 
+    bytes + nbByte);
+  // Drop the oldest samples until there is enough space
+  while (that->_capacity - that->_size < nbByte)
+    ELOHistoryDrop(that);
+  // Add the sample
+  for (int iByte = 0; iByte < nbByte; ++iByte)
+    that->_buf[(that->_head + that->_size + iByte) % that->_capacity] =
+      bytes[iByte];
+  that->_size += nbByte;
+  that->_lastMatch = match;
+  that->_lastElo = q;
+  ++(that->_nb);
+}
+
+// Drop the oldest sample of the ELOHistory 'that'
+static void ELOHistoryDrop(ELOHistory* const that) {
+  if (that->_nb <= 1) {
+    that->_nb = 0;
+    that->_head = 0;
+    that->_size = 0;
+    return;
+  }
+  // The second oldest sample becomes the oldest one
+  int pos = that->_head;
+  int nbByte = 0;
+  that->_firstMatch += ELOHistoryRead(that, &pos, &nbByte);
+  unsigned long zigzag = ELOHistoryRead(that, &pos, &nbByte);
+  that->_firstElo += (long)(zigzag >> 1) ^ -(long)(zigzag & 1);
+  that->_head = pos;
+  that->_size -= nbByte;
+  --(that->_nb);
+}
+
+// Copy the 'nb' most recent samples of the ELOHistory 'that' into 
+// 'matches' and 'elos' (which can be null)
+// Return the number of samples copied
+static int ELOHistoryGet(const ELOHistory* const that, const int nb,
+  long* const matches, float* const elos) {
+  int nbCopy = MIN(nb, that->_nb);
+  int nbSkip = that->_nb - nbCopy;
+  long match = that->_firstMatch;
+  long elo = that->_firstElo;
+  int pos = that->_head;
+  int nbByte = 0;
+  for (int iSample = 0; iSample < that->_nb; ++iSample) {
+    if (iSample > 0) {
+      match += ELOHistoryRead(that, &pos, &nbByte);
+      unsigned long zigzag = ELOHistoryRead(that, &pos, &nbByte);
+      elo += (long)(zigzag >> 1) ^ -(long)(zigzag & 1);
+    }
+    if (iSample >= nbSkip) {
+      if (matches != NULL)
+        matches[iSample - nbSkip] = match;
+      if (elos != NULL)
+        elos[iSample - nbSkip] = (float)elo * ELORANK_HISTORYRESOLUTION;
+    }
+  }
+  return nbCopy;
+}
+
+// Read the variable length integer at position 'pos' in the buffer of
+// the ELOHistory 'that', move 'pos' after it and add its number of 
+// bytes to 'nbByte'
+static unsigned long ELOHistoryRead(const ELOHistory* const that, 
+  int* const pos, int* const nbByte) {
+  unsigned long val = 0;
+  int shift = 0;
+  unsigned char byte = 0;
+  do {
+    byte = that->_buf[*pos];
+    *pos = (*pos + 1) % that->_capacity;
+    ++(*nbByte);
+    val |= (unsigned long)(byte & 0x7F) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return val;
+}
+
+// Write the variable length integer 'val' in 'bytes'
+// Return the number of bytes written
+static int ELOHistoryWrite(unsigned long val, unsigned char* const bytes) {
+  int nbByte = 0;
+  while (val >= 0x80) {
+    bytes[nbByte++] = (unsigned char)(val | 0x80);
+    val >>= 7;
+  }
+  bytes[nbByte++] = (unsigned char)val;
+  return nbByte;
+}
+
@@ -10,6 +10,7 @@
 #include <math.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "pberr.h"
 #include "gset.h"
 #include "pbmath.h"
@@ -18,9 +19,45 @@
 
 #define ELORANK_K 8.0
 #define ELORANK_STARTELO 0.0
+// Default decay rate of the ELO toward ELORANK_STARTELO per unit of time
+// (0.0 means no decay)
+#define ELORANK_DECAY 0.0
+// Maximum value of decay * (time - decay epoch) before the sort values
+// of the entities are rebased on the current time
+#define ELORANK_DECAYREBASE 16.0
+// Resolution of the ELO in the history of the entities
+#define ELORANK_HISTORYRESOLUTION 0.01
+// Minimum size in bytes of the history of an entity (enough for the
+// largest encoded sample)
+#define ELORANK_HISTORYMINSIZE 20
 
 // ================= Data structure ===================
 
+// History of the ELO of an entity after each of its updates
+// The oldest and most recent samples are stored as is, the samples in
+// between are stored as the variation of match index and ELO (in 
+// ELORANK_HISTORYRESOLUTION unit) from the previous sample, encoded
+// as variable length integers in a ring buffer of fixed size. When the
+// buffer is full the oldest samples are dropped.
+typedef struct ELOHistory {
+  // Size of the buffer in bytes
+  int _capacity;
+  // Position in the buffer of the variation to the second oldest sample
+  int _head;
+  // Number of bytes used in the buffer
+  int _size;
+  // Number of samples
+  int _nb;
+  // Match index and ELO of the oldest sample
+  long _firstMatch;
+  long _firstElo;
+  // Match index and ELO of the most recent sample
+  long _lastMatch;
+  long _lastElo;
+  // Buffer
+  unsigned char _buf[];
+} ELOHistory;
+
 typedef struct ELOEntity {
   // Pointer toward user struct
   void* _data;
@@ -31,13 +68,42 @@ typedef struct ELOEntity {
   // Flag to memorize if the entity is a milestone
   // (whose elo is blocked)
   bool _isMilestone;
+  // Time of the last update or set of the ELO of the entity
+  long _lastActivity;
+  // History of the ELO, NULL if the history is disabled for this
+  // entity
+  ELOHistory* _history;
 } ELOEntity;
 
 typedef struct ELORank {
   // ELO coefficient
   float _k;
   // Set of ELO entities
+  // The _sortVal of the elements is not directly the ELO, it is the 
+  // ELO of the entity carried to the decay epoch so that the order of 
+  // the set is kept unchanged as time goes by (cf ELORankGetELO)
   GSet _set;
+  // Set of the elements of _set whose entity is a milestone (the _data
+  // of its elements are GSetElem*)
+  GSet _milestones;
+  // Hash table of the elements of _set indexed by the user data of 
+  // their entity (open addressing with linear probing, NULL for empty
+  // entries)
+  GSetElem** _index;
+  // Number of entries in _index (0 or a power of 2)
+  unsigned long _nbIndex;
+  // Decay rate of the ELO toward ELORANK_STARTELO per unit of time
+  float _decay;
+  // Current time
+  long _time;
+  // Time of reference for the _sortVal of entities
+  long _decayEpoch;
+  // ELORank from which 'that' has been forked, NULL if 'that' is not 
+  // a fork
+  const struct ELORank* _parent;
+  // Number of results applied to 'that' (and its parents), used as
+  // the match index in the history of entities
+  long _nbMatch;
 } ELORank;
 
 
@@ -49,12 +115,28 @@ ELORank* ELORankCreate(void);
 ELORank ELORankCreateStatic(void);
 #endif*/
 
+// Create a fork of the ELORank 'that'
+// The fork shares the entities of 'that' and holds only a copy of the
+// entities modified through the fork (copy-on-write). The fork can be 
+// updated like any other ELORank, except it is not possible to add or
+// remove entities, or to modify its decay rate. 'that' must not be
+// modified nor freed as long as the fork exists. A fork can be forked
+// too.
+ELORank* ELORankFork(const ELORank* const that);
+
 // Free memory used by an ELORank
 void ELORankFree(ELORank** that);
 
 // Free memory used by an ELOEntity
 void ELOEntityFree(ELOEntity** that);
 
+// Get the ELORank from which 'that' has been forked, or NULL if 'that'
+// is not a fork
+#if BUILDMODE != 0
+static inline
+#endif
+const ELORank* ELORankGetParent(const ELORank* const that);
+
 // Set the K coefficient of 'that' to 'k' 
 #if BUILDMODE != 0
 static inline
@@ -67,6 +149,35 @@ static inline
 #endif
 float ELORankGetK(const ELORank* const that);
 
+// Set the decay rate of 'that' to 'decay' (>= 0.0)
+// The ELO of the entities decays exponentially toward ELORANK_STARTELO
+// according to the time elapsed since their last activity: 
+// elo(t) = start + (elo(last) - start) * exp(-decay * (t - last))
+void ELORankSetDecay(ELORank* const that, const float decay);
+
+// Get the decay rate of 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+float ELORankGetDecay(const ELORank* const that);
+
+// Set the current time of 'that' to 't'
+// The time can't go backward
+void ELORankSetTime(ELORank* const that, const long t);
+
+// Get the current time of 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+long ELORankGetTime(const ELORank* const that);
+
+// Get the number of results applied to 'that' since its creation
+// (including the ones applied to its parents before the fork)
+#if BUILDMODE != 0
+static inline
+#endif
+long ELORankGetNbMatch(const ELORank* const that);
+
 // Add the entity 'data' to 'that' 
 void ELORankAdd(ELORank* const that, void* const data);
 
@@ -88,12 +199,53 @@ int ELORankGetNb(const ELORank* const that);
 // Elements in the result set must be in the ELORank 
 void ELORankUpdate(ELORank* const that, const GSet* const res);
 
+// Update the ranks in 'that' with the 'nb' results 'res', applied in 
+// the order of the array as if ELORankUpdate was called on each of them
+// but the entities are sorted only once after the last result
+void ELORankUpdateBatch(ELORank* const that, const int nb, 
+  const GSet* const* const res);
+
+// Add to 'deltas' the variation of ELO of the 'nb' entities whose 
+// current ELO are 'elos' and scores in an evaluation are 'scores' 
+// (higher is better, equal means tie), for the ELO coefficient 'k'
+// This is the calculation used by ELORankUpdate
+void ELORankAddDeltaELO(const float k, const int nb, 
+  const float* const elos, const float* const scores, 
+  float* const deltas);
+
 // Get the current rank of the entity 'data' (starts at 0)
 int ELORankGetRank(const ELORank* const that, const void* const data);
 
 // Get the current ELO of the entity 'data'
 float ELORankGetELO(const ELORank* const that, const void* const data);
 
+// Get the expected scores of the 'nb' entities 'data' in 'that' 
+// against each other
+// 'mat' is an array of nb*nb floats receiving, at index i*nb+j, the
+// probability that 'data'[i] wins against 'data'[j], calculated with 
+// the same formula as ELORankUpdate: 1/(1+10^((elo_j-elo_i)/400))
+// (the diagonal is equal to 0.5)
+// If 'placement' is not null it's an array of nb floats receiving the
+// expected placement of each entity in a match between the 'nb' 
+// entities (0.0 means first place)
+// No memory is allocated on the heap
+void ELORankGetExpectedScores(const ELORank* const that, const int nb, 
+  const void* const* const data, float* const mat, 
+  float* const placement);
+
+// Get the expected scores of the 'nbLobby' lobbies of entities in 
+// 'that'
+// 'sizes' gives the number of entities in each lobby and 'data' the
+// entities of all the lobbies one after the other
+// 'mats' receives the matrix of expected scores of each lobby one after
+// the other (sum of sizes[i]^2 floats) and 'placements', if not null,
+// the expected placement of entities in their lobby (sum of sizes[i]
+// floats), cf ELORankGetExpectedScores
+void ELORankGetLobbiesExpectedScores(const ELORank* const that, 
+  const int nbLobby, const int* const sizes, 
+  const void* const* const data, float* const mats, 
+  float* const placements);
+
 // Get the current soft ELO (average of elo over nb of evaluation) 
 // of the entity 'data'
 float ELORankGetSoftELO(const ELORank* const that, 
@@ -103,6 +255,10 @@ float ELORankGetSoftELO(const ELORank* const that,
 void ELORankSetELO(const ELORank* const that, const void* const data, 
   const float elo);
 
+// Get the time of the last activity of the entity 'data'
+long ELORankGetLastActivity(const ELORank* const that, 
+  const void* const data);
+
 // Set the milestone flag of the entity 'data' to 'flag'
 void ELORankSetIsMilestone(const ELORank* const that, 
   const void* const data, const bool flag);
@@ -113,6 +269,34 @@ void ELORankResetAllMilestone(const ELORank* const that);
 // Reset the current ELO of the entity 'data'
 void ELORankResetELO(const ELORank* const that, const void* const data);
 
+// Set the size in bytes of the history of the entity 'data' to 'size'
+// (0 to disable the history, else at least ELORANK_HISTORYMINSIZE)
+// When enabled, a sample (match index, ELO after the match) is added
+// to the history at each update of the entity, the oldest samples 
+// being dropped when the history is full. A sample uses usually 2 to 4
+// bytes. The history is disabled by default.
+void ELORankSetHistorySize(const ELORank* const that, 
+  const void* const data, const int size);
+
+// Get the size in bytes of the history of the entity 'data' (0 if the
+// history is disabled)
+int ELORankGetHistorySize(const ELORank* const that, 
+  const void* const data);
+
+// Get the number of samples in the history of the entity 'data'
+int ELORankGetHistoryNb(const ELORank* const that, 
+  const void* const data);
+
+// Get the 'nb' most recent samples of the history of the entity 'data'
+// 'matches' and 'elos' (which can be null) are arrays of 'nb' 
+// elements receiving the match index and ELO (rounded to 
+// ELORANK_HISTORYRESOLUTION) of the samples from the oldest to the 
+// most recent
+// Return the number of samples copied (less than 'nb' if the history
+// contains less samples)
+int ELORankGetHistory(const ELORank* const that, const void* const data,
+  const int nb, long* const matches, float* const elos);
+
 // Get the 'rank'-th entity according to current ELO of 'that'  
 // (starts at 0)
 const ELOEntity* ELORankGetRanked(const ELORank* const that, const int rank);
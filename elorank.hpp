@@ -0,0 +1,521 @@
+// ============ ELORANK.HPP ================
+
+#ifndef ELORANK_HPP
+#define ELORANK_HPP
+
+// Header-only C++ front end of ELORank
+// The rating core is templated on the type of the entities' id, the
+// floating point precision, the K-schedule policy and the milestone
+// policy. With Real = float, a constant K and milestones enabled, the
+// ELO and soft ELO are the same as the ones calculated by the C
+// implementation (ELORankUpdate) for the same sequence of results.
+// Matches of 2 to 8 entities are processed on arrays whose size is
+// known at compile time, allocated on the stack.
+
+// ================= Include =================
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ================= Define ==================
+
+// Same values as ELORANK_K, ELORANK_STARTELO and the tolerance of
+// ISEQUALF (PBMATH_EPSILON) in the C implementation
+// This header doesn't depend on the C one, if the C header is included
+// before this one the values are checked at compile time
+#define ELORANKHPP_K 8
+#define ELORANKHPP_STARTELO 0.0
+#define ELORANKHPP_EPSILON 0.00001
+#ifdef ELORANK_H
+static_assert(ELORANKHPP_K == ELORANK_K,
+  "ELORANKHPP_K differs from ELORANK_K");
+static_assert(ELORANKHPP_STARTELO == ELORANK_STARTELO,
+  "ELORANKHPP_STARTELO differs from ELORANK_STARTELO");
+static_assert(ELORANKHPP_EPSILON == PBMATH_EPSILON,
+  "ELORANKHPP_EPSILON differs from PBMATH_EPSILON");
+#endif
+
+// ================= K-schedule policies ===================
+
+// Constant K coefficient known at compile time
+template <int K = ELORANKHPP_K>
+struct ELOKFixed {
+  // Get the K coefficient of an entity with 'nbRun' evaluations
+  template <typename Real>
+  Real GetK(const long nbRun) const {
+    (void)nbRun;
+    return Real(K);
+  }
+};
+
+// Constant K coefficient set at run time (as ELORankSetK)
+struct ELOKConstant {
+  // ELO coefficient
+  float _k = ELORANKHPP_K;
+  // Get the K coefficient of an entity with 'nbRun' evaluations
+  template <typename Real>
+  Real GetK(const long nbRun) const {
+    (void)nbRun;
+    return Real(_k);
+  }
+};
+
+// K coefficient 'KHigh' during the 'NbProvisional' first evaluations of
+// an entity, then 'KLow'
+template <int KHigh, int KLow, long NbProvisional>
+struct ELOKProvisional {
+  // Get the K coefficient of an entity with 'nbRun' evaluations
+  template <typename Real>
+  Real GetK(const long nbRun) const {
+    return Real(nbRun < NbProvisional ? KHigh : KLow);
+  }
+};
+
+// ================= Milestone policies ===================
+
+// The ELO of entities flagged as milestone is blocked (as in the C
+// implementation)
+struct ELOMilestoneFlag {
+  static constexpr bool _isEnabled = true;
+};
+
+// No milestone, the check is removed at compile time
+struct ELOMilestoneNone {
+  static constexpr bool _isEnabled = false;
+};
+
+// ================= Data structure ===================
+
+// Rating of an entity
+template <typename Real>
+struct ELORating {
+  // Current ELO
+  Real _elo;
+  // Sum of evaluation
+  Real _sumSoftElo;
+  // Number of evaluation
+  long _nbRun;
+  // Flag to memorize if the entity is a milestone
+  // (whose elo is blocked)
+  bool _isMilestone;
+  // Current rank (starts at 0)
+  std::size_t _rank;
+};
+
+// Result of a match between 'N' entities, allocated on the stack
+// '_scores'[i] is the score of the entity '_ids'[i] (higher is
+// better, equal means tie)
+template <typename Id, typename Real, std::size_t N>
+struct ELOResult {
+  std::array<Id, N> _ids;
+  std::array<Real, N> _scores;
+};
+
+// ================ Functions ====================
+
+// Add to 'delta' the variation of ELO of the entity A, of ELO 'eloA',
+// score 'scoreA' and K coefficient 'k', due to the entity B of ELO
+// 'eloB' and score 'scoreB'
+// The calculation, including the conversions between Real and double,
+// is the same as ELORankAddDeltaELO
+template <typename Real>
+inline void ELOAddDeltaELOPair(const Real k, const Real eloA,
+  const Real eloB, const Real scoreA, const Real scoreB, Real& delta) {
+  // Ignore tie and match with itself
+  if (std::fabs(scoreA - scoreB) < ELORANKHPP_EPSILON)
+    return;
+  Real p = Real(1.0 / (1.0 + std::pow(10.0, (eloB - eloA) / 400.0)));
+  // If A has won
+  if (scoreA > scoreB)
+    delta = Real(delta + k * (1.0 - p));
+  // Else, if A has lost
+  else
+    delta = Real(delta + -1.0 * k * p);
+}
+
+// Add to 'deltas' the variation of ELO of the 'N' entities whose K
+// coefficient are 'k', current ELO are 'elos' and scores in an
+// evaluation are 'scores' (higher is better, equal means tie)
+// 'N' being known at compile time the loops can be unrolled
+template <typename Real, std::size_t N>
+inline void ELOAddDeltaELO(const std::array<Real, N>& k,
+  const std::array<Real, N>& elos, const std::array<Real, N>& scores,
+  std::array<Real, N>& deltas) {
+  for (std::size_t iA = 0; iA < N; ++iA)
+    for (std::size_t iB = 0; iB < N; ++iB)
+      ELOAddDeltaELOPair(k[iA], elos[iA], elos[iB], scores[iA],
+        scores[iB], deltas[iA]);
+}
+
+// Add to 'deltas' the variation of ELO of the 'nb' entities whose K
+// coefficient are 'k', current ELO are 'elos' and scores in an
+// evaluation are 'scores' (higher is better, equal means tie)
+template <typename Real>
+inline void ELOAddDeltaELO(const std::size_t nb, const Real* const k,
+  const Real* const elos, const Real* const scores,
+  Real* const deltas) {
+  for (std::size_t iA = 0; iA < nb; ++iA)
+    for (std::size_t iB = 0; iB < nb; ++iB)
+      ELOAddDeltaELOPair(k[iA], elos[iA], elos[iB], scores[iA],
+        scores[iB], deltas[iA]);
+}
+
+// Set 'order' with the indices of the 'nb' 'scores' in increasing
+// order of score, equal scores staying in their original order (the
+// order of the elements of the result set in ELORankUpdate, which the
+// sums of ELOAddDeltaELOPair must follow to be rounded the same)
+template <typename Real>
+inline void ELOSortByScore(const std::size_t nb, const Real* const scores,
+  std::size_t* const order) {
+  for (std::size_t i = 0; i < nb; ++i) {
+    std::size_t j = i;
+    while (j > 0 && scores[order[j - 1]] > scores[i]) {
+      order[j] = order[j - 1];
+      --j;
+    }
+    order[j] = i;
+  }
+}
+
+// ================= Ranking ===================
+
+// Ranking of entities identified by an 'Id'
+// The entities are kept in decreasing order of ELO, the rank of an
+// entity is then available in constant time. After an update the new
+// rank of an entity is searched by dichotomy, and the entities between
+// its previous and new ranks are shifted by one rank run by run, a run
+// being the entities of equal ELO (only the first or last entity of a
+// run is moved), so many entities sharing the start ELO cost as much as
+// one.
+// Errors are checked and reported as exceptions when BUILDMODE is 0
+// (or undefined), as in the C implementation
+template <typename Id, typename Real = float,
+  typename KPolicy = ELOKConstant,
+  typename MilestonePolicy = ELOMilestoneFlag,
+  typename Hash = std::hash<Id>>
+class ELORankTpl {
+public:
+  typedef ELORating<Real> Rating;
+
+  // Create a new ranking whose entities start at 'startElo' with the
+  // K-schedule 'kPolicy'
+  explicit ELORankTpl(const Real startElo = Real(ELORANKHPP_STARTELO),
+    const KPolicy& kPolicy = KPolicy()) :
+    _startElo(startElo), _kPolicy(kPolicy) {}
+
+  // Get the K-schedule policy
+  KPolicy& GetKPolicy() {
+    return _kPolicy;
+  }
+  const KPolicy& GetKPolicy() const {
+    return _kPolicy;
+  }
+
+  // Get the start ELO
+  Real GetStartELO() const {
+    return _startElo;
+  }
+
+  // Get the number of entity
+  std::size_t GetNb() const {
+    return _ranked.size();
+  }
+
+  // Return true if the entity 'id' is in the ranking
+  bool Contains(const Id& id) const {
+    return _ratings.find(id) != _ratings.end();
+  }
+
+  // Add the entity 'id'
+  void Add(const Id& id) {
+    Rating rating = {_startElo, Real(0.0), 0, false, _ranked.size()};
+    if (_ratings.emplace(id, rating).second == false) {
+#if BUILDMODE == 0
+      throw std::invalid_argument("ELORankTpl::Add: entity already added");
+#endif
+      return;
+    }
+    _ranked.push_back(id);
+    Move(_ratings.find(id)->second);
+  }
+
+  // Remove the entity 'id'
+  void Remove(const Id& id) {
+    auto it = _ratings.find(id);
+    if (it == _ratings.end())
+      return;
+    MoveHole(it->second._rank, _ranked.size() - 1);
+    _ranked.pop_back();
+    _ratings.erase(it);
+  }
+
+  // Update the ranking with the result 'res' of a match between 'N'
+  // entities
+  template <std::size_t N>
+  void Update(const ELOResult<Id, Real, N>& res) {
+    static_assert(N >= 2, "a result contains at least 2 entities");
+    UpdateFixed<N>(res._ids.data(), res._scores.data());
+  }
+
+  // Update the ranking with the result of a match between the 'nb'
+  // entities 'ids' whose scores are 'scores' (higher is better, equal
+  // means tie)
+  // Matches of 2 to 8 entities use the fixed size implementation, the
+  // other ones use arrays allocated on the heap
+  void Update(const std::size_t nb, const Id* const ids,
+    const Real* const scores) {
+#if BUILDMODE == 0
+    if (nb < 2)
+      throw std::invalid_argument(
+        "ELORankTpl::Update: a result contains at least 2 entities");
+#endif
+    switch (nb) {
+      case 2: UpdateFixed<2>(ids, scores); break;
+      case 3: UpdateFixed<3>(ids, scores); break;
+      case 4: UpdateFixed<4>(ids, scores); break;
+      case 5: UpdateFixed<5>(ids, scores); break;
+      case 6: UpdateFixed<6>(ids, scores); break;
+      case 7: UpdateFixed<7>(ids, scores); break;
+      case 8: UpdateFixed<8>(ids, scores); break;
+      default: UpdateDynamic(nb, ids, scores); break;
+    }
+  }
+
+  // Get the current rank of the entity 'id' (starts at 0)
+  std::size_t GetRank(const Id& id) const {
+    return GetRating(id)._rank;
+  }
+
+  // Get the current ELO of the entity 'id'
+  Real GetELO(const Id& id) const {
+    return GetRating(id)._elo;
+  }
+
+  // Get the current soft ELO (average of elo over nb of evaluation)
+  // of the entity 'id'
+  Real GetSoftELO(const Id& id) const {
+    const Rating& rating = GetRating(id);
+    if (rating._nbRun > 0)
+      return rating._sumSoftElo /
+        Real(rating._nbRun < 100 ? rating._nbRun : 100);
+    return _startElo;
+  }
+
+  // Get the number of evaluation of the entity 'id'
+  long GetNbRun(const Id& id) const {
+    return GetRating(id)._nbRun;
+  }
+
+  // Get the id of the 'rank'-th entity according to current ELO
+  // (starts at 0)
+  const Id& GetRanked(const std::size_t rank) const {
+#if BUILDMODE == 0
+    if (rank >= _ranked.size())
+      throw std::out_of_range("ELORankTpl::GetRanked: invalid rank " +
+        std::to_string(rank));
+#endif
+    return _ranked[rank];
+  }
+
+  // Set the current ELO of the entity 'id' to 'elo'
+  void SetELO(const Id& id, const Real elo) {
+    Rating& rating = GetRating(id);
+    rating._elo = elo;
+    Move(rating);
+  }
+
+  // Reset the current ELO, soft ELO and number of evaluation of the
+  // entity 'id'
+  void ResetELO(const Id& id) {
+    Rating& rating = GetRating(id);
+    rating._elo = _startElo;
+    rating._sumSoftElo = Real(0.0);
+    rating._nbRun = 0;
+    Move(rating);
+  }
+
+  // Set the milestone flag of the entity 'id' to 'flag'
+  void SetIsMilestone(const Id& id, const bool flag) {
+    static_assert(MilestonePolicy::_isEnabled,
+      "milestones are disabled by the milestone policy");
+    GetRating(id)._isMilestone = flag;
+  }
+
+  // Get the milestone flag of the entity 'id'
+  bool GetIsMilestone(const Id& id) const {
+    return MilestonePolicy::_isEnabled && GetRating(id)._isMilestone;
+  }
+
+  // Reset the milestone flag of all the entitities to false
+  void ResetAllMilestone() {
+    for (auto& it : _ratings)
+      it.second._isMilestone = false;
+  }
+
+private:
+  // ELO of new entities
+  Real _startElo;
+  // K-schedule
+  KPolicy _kPolicy;
+  // Rating of the entities
+  std::unordered_map<Id, Rating, Hash> _ratings;
+  // Id of the entities in decreasing order of ELO
+  std::vector<Id> _ranked;
+
+  // Get the rating of the entity 'id'
+  Rating& GetRating(const Id& id) {
+    auto it = _ratings.find(id);
+#if BUILDMODE == 0
+    if (it == _ratings.end())
+      throw std::out_of_range(
+        "ELORankTpl: entity can't be found in the ranking");
+#endif
+    return it->second;
+  }
+  const Rating& GetRating(const Id& id) const {
+    auto it = _ratings.find(id);
+#if BUILDMODE == 0
+    if (it == _ratings.end())
+      throw std::out_of_range(
+        "ELORankTpl: entity can't be found in the ranking");
+#endif
+    return it->second;
+  }
+
+  // Update the ranking with the result of a match between 'N' entities
+  template <std::size_t N>
+  void UpdateFixed(const Id* const ids, const Real* const scores) {
+    std::array<std::size_t, N> order;
+    ELOSortByScore(N, scores, order.data());
+    std::array<Rating*, N> ratings;
+    std::array<Real, N> k;
+    std::array<Real, N> elos;
+    std::array<Real, N> score;
+    std::array<Real, N> deltas;
+    for (std::size_t i = 0; i < N; ++i) {
+      ratings[i] = &GetRating(ids[order[i]]);
+      k[i] = _kPolicy.template GetK<Real>(ratings[i]->_nbRun);
+      elos[i] = ratings[i]->_elo;
+      score[i] = scores[order[i]];
+      deltas[i] = Real(0.0);
+    }
+    ELOAddDeltaELO(k, elos, score, deltas);
+    Apply(N, ratings.data(), deltas.data());
+  }
+
+  // Update the ranking with the result of a match between 'nb'
+  // entities
+  void UpdateDynamic(const std::size_t nb, const Id* const ids,
+    const Real* const scores) {
+    std::vector<std::size_t> order(nb);
+    ELOSortByScore(nb, scores, order.data());
+    std::vector<Rating*> ratings(nb);
+    std::vector<Real> k(nb);
+    std::vector<Real> elos(nb);
+    std::vector<Real> score(nb);
+    std::vector<Real> deltas(nb, Real(0.0));
+    for (std::size_t i = 0; i < nb; ++i) {
+      ratings[i] = &GetRating(ids[order[i]]);
+      k[i] = _kPolicy.template GetK<Real>(ratings[i]->_nbRun);
+      elos[i] = ratings[i]->_elo;
+      score[i] = scores[order[i]];
+    }
+    ELOAddDeltaELO(nb, k.data(), elos.data(), score.data(),
+      deltas.data());
+    Apply(nb, ratings.data(), deltas.data());
+  }
+
+  // Apply the variation of ELO 'deltas' to the 'nb' entities of
+  // ratings 'ratings' and update their number of run and soft ELO
+  void Apply(const std::size_t nb, Rating* const* const ratings,
+    const Real* const deltas) {
+    for (std::size_t i = 0; i < nb; ++i) {
+      Rating& rating = *(ratings[i]);
+      // If the entity is a milestone, its elo is blocked to its current
+      // value
+      if (!(MilestonePolicy::_isEnabled && rating._isMilestone)) {
+        rating._elo += deltas[i];
+        Move(rating);
+      }
+      ++(rating._nbRun);
+      if (rating._nbRun >= 100)
+        rating._sumSoftElo = Real(rating._sumSoftElo * 0.99);
+      rating._sumSoftElo += rating._elo;
+    }
+  }
+
+  // Get the ELO of the entity at rank 'rank'
+  Real GetELOAt(const std::size_t rank) const {
+    return _ratings.find(_ranked[rank])->second._elo;
+  }
+
+  // Get the first rank in ['first', 'last'[ whose entity has an ELO
+  // lower than 'elo', or lower or equal if 'orEqual' is true, or 'last'
+  // if there is none
+  std::size_t SearchRank(std::size_t first, std::size_t last,
+    const Real elo, const bool orEqual) const {
+    while (first < last) {
+      std::size_t mid = first + (last - first) / 2;
+      Real eloMid = GetELOAt(mid);
+      if (eloMid < elo || (orEqual && eloMid == elo))
+        last = mid;
+      else
+        first = mid + 1;
+    }
+    return first;
+  }
+
+  // Move the free rank 'from' to the rank 'to', the entities in
+  // between being shifted by one rank toward 'from'
+  // The entities keep their order of ELO, but inside a run of entities
+  // of equal ELO only the entity at the end of the run opposite to the
+  // free rank is moved, to the free rank
+  void MoveHole(std::size_t from, const std::size_t to) {
+    // Shift the entities toward the last rank
+    while (from > to) {
+      Real elo = GetELOAt(from - 1);
+      std::size_t rank = SearchRank(to, from - 1, elo, true);
+      _ranked[from] = _ranked[rank];
+      _ratings.find(_ranked[from])->second._rank = from;
+      from = rank;
+    }
+    // Shift the entities toward the first rank
+    while (from < to) {
+      Real elo = GetELOAt(from + 1);
+      std::size_t rank = SearchRank(from + 1, to + 1, elo, false) - 1;
+      _ranked[from] = _ranked[rank];
+      _ratings.find(_ranked[from])->second._rank = from;
+      from = rank;
+    }
+  }
+
+  // Move the entity of rating 'rating' in the ranking after its ELO
+  // has changed
+  // The id of the entity is taken from the ranking itself, as the id
+  // given by the user may be a reference to an element of _ranked
+  // The entity is placed after the entities of higher or equal ELO if
+  // it moves toward the first rank, before the entities of lower or
+  // equal ELO else
+  void Move(Rating& rating) {
+    std::size_t rank = rating._rank;
+    Id id(std::move(_ranked[rank]));
+    std::size_t newRank = rank;
+    if (rank > 0 && GetELOAt(rank - 1) < rating._elo)
+      newRank = SearchRank(0, rank, rating._elo, false);
+    else if (rank + 1 < _ranked.size() && GetELOAt(rank + 1) > rating._elo)
+      newRank =
+        SearchRank(rank + 1, _ranked.size(), rating._elo, true) - 1;
+    MoveHole(rank, newRank);
+    _ranked[newRank] = std::move(id);
+    rating._rank = newRank;
+  }
+};
+
+#endif
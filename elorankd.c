@@ -0,0 +1,659 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "elorank.h"
+#include "elorank-daemon.h"
+#include "pberr.h"
+#include "pbmath.h"
+
+// Number of bytes read at most from one client per cycle
+#define ELODAEMON_READSIZE 65536
+
+// Connection of one client
+typedef struct ELODaemonClient {
+  // Socket of the client, -1 once disconnected
+  int _fd;
+  // Bytes received and not yet processed
+  char* _in;
+  size_t _inSize;
+  size_t _inCap;
+  // Number of bytes at the beginning of _in made of complete requests
+  // found during the current cycle
+  size_t _parsed;
+  // Validity (0 or 1) of each update request among the complete
+  // requests, in the order of the requests
+  char* _valid;
+  size_t _nbValid;
+  size_t _capValid;
+  // Responses not yet sent, from _outSent to _outSize
+  char* _out;
+  size_t _outSize;
+  size_t _outCap;
+  size_t _outSent;
+} ELODaemonClient;
+
+// State of the daemon
+typedef struct ELODaemon {
+  // The ranking
+  ELORank* _rank;
+  // Maximum number of entities
+  uint32_t _nbMax;
+  // Id of each entity, the address of _ids[id] is the user data of the
+  // entity 'id' in the ranking
+  uint32_t* _ids;
+  // Flag for each id to memorize if the entity is in the ranking
+  bool* _known;
+  // Results received during the current cycle
+  GSet* _batch;
+  const GSet** _batchPtr;
+  int _nbBatch;
+  int _capBatch;
+  // Read-optimized view of the ranking, updated after each batch of
+  // updates for the entities of the batch only: rank, ELO and soft ELO
+  // indexed by id, and ids in increasing rank
+  int32_t* _viewRank;
+  float* _viewELO;
+  float* _viewSoftELO;
+  uint32_t* _viewRanked;
+  uint32_t _viewNb;
+  // Flag for each id to memorize if the entity has already been updated
+  // in the view for the current batch
+  bool* _viewDone;
+  // Clients
+  ELODaemonClient* _clients;
+  int _nbClient;
+  int _capClient;
+} ELODaemon;
+
+// Flag raised by SIGINT and SIGTERM
+static volatile sig_atomic_t flagStop = 0;
+
+// Handler of SIGINT and SIGTERM
+static void ELODaemonOnSignal(int sig) {
+  (void)sig;
+  flagStop = 1;
+}
+
+// Reallocate the memory 'ptr' to 'size' bytes
+static void* ELODaemonRealloc(void* const ptr, const size_t size) {
+  void* mem = realloc(ptr, size);
+  if (mem == NULL) {
+    ELORankErr->_type = PBErrTypeMallocFailed;
+    sprintf(ELORankErr->_msg, "realloc of %zu bytes failed", size);
+    PBErrCatch(ELORankErr);
+  }
+  return mem;
+}
+
+// Make sure the buffer 'buf' of capacity 'cap' can hold 'size' bytes
+static void ELODaemonReserve(char** const buf, size_t* const cap,
+  const size_t size) {
+  if (size <= *cap)
+    return;
+  size_t newCap = (*cap > 0 ? *cap : 4096);
+  while (newCap < size)
+    newCap *= 2;
+  *buf = ELODaemonRealloc(*buf, newCap);
+  *cap = newCap;
+}
+
+// Create the state of a daemon for 'nbMax' entities with ELO
+// coefficient 'k'
+static ELODaemon* ELODaemonCreate(const uint32_t nbMax, const float k) {
+  ELODaemon* that = PBErrMalloc(ELORankErr, sizeof(ELODaemon));
+  memset(that, 0, sizeof(ELODaemon));
+  that->_rank = ELORankCreate();
+  ELORankSetK(that->_rank, k);
+  that->_nbMax = nbMax;
+  that->_ids = PBErrMalloc(ELORankErr, sizeof(uint32_t) * nbMax);
+  that->_known = PBErrMalloc(ELORankErr, sizeof(bool) * nbMax);
+  that->_viewRank = PBErrMalloc(ELORankErr, sizeof(int32_t) * nbMax);
+  that->_viewELO = PBErrMalloc(ELORankErr, sizeof(float) * nbMax);
+  that->_viewSoftELO = PBErrMalloc(ELORankErr, sizeof(float) * nbMax);
+  that->_viewRanked = PBErrMalloc(ELORankErr, sizeof(uint32_t) * nbMax);
+  that->_viewDone = PBErrMalloc(ELORankErr, sizeof(bool) * nbMax);
+  for (uint32_t id = nbMax; id--;) {
+    that->_ids[id] = id;
+    that->_known[id] = false;
+    that->_viewRank[id] = -1;
+    that->_viewELO[id] = ELORANK_STARTELO;
+    that->_viewSoftELO[id] = ELORANK_STARTELO;
+    that->_viewDone[id] = false;
+  }
+  return that;
+}
+
+// Free the state of the daemon 'that'
+static void ELODaemonFree(ELODaemon** that) {
+  if (that == NULL || *that == NULL) return;
+  for (int iClient = (*that)->_nbClient; iClient--;) {
+    if ((*that)->_clients[iClient]._fd >= 0)
+      close((*that)->_clients[iClient]._fd);
+    free((*that)->_clients[iClient]._in);
+    free((*that)->_clients[iClient]._out);
+    free((*that)->_clients[iClient]._valid);
+  }
+  free((*that)->_clients);
+  for (int iRes = (*that)->_capBatch; iRes--;)
+    GSetFlush((*that)->_batch + iRes);
+  free((*that)->_batch);
+  free((*that)->_batchPtr);
+  free((*that)->_viewDone);
+  free((*that)->_viewRanked);
+  free((*that)->_viewSoftELO);
+  free((*that)->_viewELO);
+  free((*that)->_viewRank);
+  free((*that)->_known);
+  free((*that)->_ids);
+  ELORankFree(&((*that)->_rank));
+  free(*that);
+  *that = NULL;
+}
+
+// Add a new client connected on 'fd' to 'that'
+static void ELODaemonAddClient(ELODaemon* const that, const int fd) {
+  if (that->_nbClient == that->_capClient) {
+    that->_capClient = (that->_capClient > 0 ? that->_capClient * 2 : 8);
+    that->_clients = ELODaemonRealloc(that->_clients,
+      sizeof(ELODaemonClient) * that->_capClient);
+  }
+  ELODaemonClient* client = that->_clients + that->_nbClient;
+  memset(client, 0, sizeof(ELODaemonClient));
+  client->_fd = fd;
+  ++(that->_nbClient);
+}
+
+// Close the connection of the client 'client'
+static void ELODaemonCloseClient(ELODaemonClient* const client) {
+  if (client->_fd >= 0)
+    close(client->_fd);
+  client->_fd = -1;
+}
+
+// Remove the disconnected clients from 'that'
+static void ELODaemonPackClients(ELODaemon* const that) {
+  int nb = 0;
+  for (int iClient = 0; iClient < that->_nbClient; ++iClient) {
+    if (that->_clients[iClient]._fd >= 0) {
+      that->_clients[nb++] = that->_clients[iClient];
+    } else {
+      free(that->_clients[iClient]._in);
+      free(that->_clients[iClient]._out);
+      free(that->_clients[iClient]._valid);
+    }
+  }
+  that->_nbClient = nb;
+}
+
+// Get the message starting at 'offset' in the 'size' bytes of 'buf'
+// Return false if the message is not complete yet
+static bool ELODaemonGetMsg(const char* const buf, const size_t size,
+  const size_t offset, ELODaemonHeader* const header,
+  const char** const payload) {
+  if (size - offset < sizeof(ELODaemonHeader))
+    return false;
+  memcpy(header, buf + offset, sizeof(ELODaemonHeader));
+  if (size - offset - sizeof(ELODaemonHeader) < header->_size)
+    return false;
+  *payload = buf + offset + sizeof(ELODaemonHeader);
+  return true;
+}
+
+// Check the payload of an update request of 'size' bytes
+static bool ELODaemonCheckUpdate(const ELODaemon* const that,
+  const char* const payload, const uint32_t size) {
+  if (size % sizeof(ELODaemonResult) != 0)
+    return false;
+  int nb = size / sizeof(ELODaemonResult);
+  if (nb < 2 || nb > ELODAEMON_MAXMATCHSIZE)
+    return false;
+  ELODaemonResult res[ELODAEMON_MAXMATCHSIZE];
+  memcpy(res, payload, size);
+  for (int iRes = nb; iRes--;) {
+    if (res[iRes]._id >= that->_nbMax || isnan(res[iRes]._score))
+      return false;
+    for (int jRes = iRes; jRes--;)
+      if (res[iRes]._id == res[jRes]._id)
+        return false;
+  }
+  return true;
+}
+
+// Queue the results of the update request 'payload' of 'size' bytes in
+// the batch of 'that', adding the unknown entities to the ranking
+static void ELODaemonQueueUpdate(ELODaemon* const that,
+  const char* const payload, const uint32_t size) {
+  if (that->_nbBatch == that->_capBatch) {
+    int cap = (that->_capBatch > 0 ? that->_capBatch * 2 : 64);
+    that->_batch = ELODaemonRealloc(that->_batch, sizeof(GSet) * cap);
+    that->_batchPtr =
+      ELODaemonRealloc(that->_batchPtr, sizeof(GSet*) * cap);
+    for (int iRes = that->_capBatch; iRes < cap; ++iRes)
+      that->_batch[iRes] = GSetCreateStatic();
+    that->_capBatch = cap;
+  }
+  GSet* set = that->_batch + that->_nbBatch;
+  int nb = size / sizeof(ELODaemonResult);
+  ELODaemonResult res[ELODAEMON_MAXMATCHSIZE];
+  memcpy(res, payload, size);
+  for (int iRes = 0; iRes < nb; ++iRes) {
+    uint32_t id = res[iRes]._id;
+    if (that->_known[id] == false) {
+      ELORankAdd(that->_rank, that->_ids + id);
+      that->_known[id] = true;
+    }
+    GSetAddSort(set, that->_ids + id, res[iRes]._score);
+  }
+  ++(that->_nbBatch);
+}
+
+// Get the first rank in ['first', 'last'[ of the view of 'that' whose
+// entity has an ELO lower than 'elo', or lower or equal if 'orEqual' 
+// is true, or 'last' if there is none
+static uint32_t ELODaemonViewSearchRank(const ELODaemon* const that,
+  uint32_t first, uint32_t last, const float elo, const bool orEqual) {
+  while (first < last) {
+    uint32_t mid = first + (last - first) / 2;
+    float eloMid = that->_viewELO[that->_viewRanked[mid]];
+    if (eloMid < elo || (orEqual && eloMid == elo))
+      last = mid;
+    else
+      first = mid + 1;
+  }
+  return first;
+}
+
+// Move the free rank 'from' of the view of 'that' to the rank 'to', 
+// the entities in between being shifted by one rank toward 'from'
+// Inside a run of entities of equal ELO only the entity at the end of
+// the run opposite to the free rank is moved, to the free rank
+static void ELODaemonViewMoveHole(ELODaemon* const that, uint32_t from,
+  const uint32_t to) {
+  while (from > to) {
+    float elo = that->_viewELO[that->_viewRanked[from - 1]];
+    uint32_t rank = ELODaemonViewSearchRank(that, to, from - 1, elo, true);
+    that->_viewRanked[from] = that->_viewRanked[rank];
+    that->_viewRank[that->_viewRanked[from]] = from;
+    from = rank;
+  }
+  while (from < to) {
+    float elo = that->_viewELO[that->_viewRanked[from + 1]];
+    uint32_t rank =
+      ELODaemonViewSearchRank(that, from + 1, to + 1, elo, false) - 1;
+    that->_viewRanked[from] = that->_viewRanked[rank];
+    that->_viewRank[that->_viewRanked[from]] = from;
+    from = rank;
+  }
+}
+
+// Update the view of 'that' for the entity 'id' of the ranking
+// The entity is added at the end of the view if it's not in it yet,
+// then moved to its new rank, which is searched by dichotomy. The other
+// entities of the view must be in decreasing order of ELO.
+static void ELODaemonViewUpdate(ELODaemon* const that, const uint32_t id) {
+  const void* data = that->_ids + id;
+  if (that->_viewRank[id] < 0) {
+    that->_viewRank[id] = that->_viewNb;
+    that->_viewRanked[that->_viewNb] = id;
+    ++(that->_viewNb);
+  }
+  float elo = ELORankGetELO(that->_rank, data);
+  that->_viewELO[id] = elo;
+  that->_viewSoftELO[id] = ELORankGetSoftELO(that->_rank, data);
+  uint32_t rank = that->_viewRank[id];
+  uint32_t newRank = rank;
+  if (rank > 0 && that->_viewELO[that->_viewRanked[rank - 1]] < elo)
+    newRank = ELODaemonViewSearchRank(that, 0, rank, elo, false);
+  else if (rank + 1 < that->_viewNb &&
+    that->_viewELO[that->_viewRanked[rank + 1]] > elo)
+    newRank =
+      ELODaemonViewSearchRank(that, rank + 1, that->_viewNb, elo, true) - 1;
+  ELODaemonViewMoveHole(that, rank, newRank);
+  that->_viewRanked[newRank] = id;
+  that->_viewRank[id] = newRank;
+}
+
+// Update the view of 'that' for the entities of the current batch
+// The cost depends on the number of entities in the batch and the 
+// distance they move, not on the number of entities in the ranking
+static void ELODaemonUpdateView(ELODaemon* const that) {
+  for (int iRes = 0; iRes < that->_nbBatch; ++iRes) {
+    for (GSetElem* elem = that->_batch[iRes]._head; elem != NULL;
+      elem = elem->_next) {
+      uint32_t id = *(uint32_t*)(elem->_data);
+      if (that->_viewDone[id] == false) {
+        that->_viewDone[id] = true;
+        ELODaemonViewUpdate(that, id);
+      }
+    }
+  }
+  for (int iRes = 0; iRes < that->_nbBatch; ++iRes)
+    for (GSetElem* elem = that->_batch[iRes]._head; elem != NULL;
+      elem = elem->_next)
+      that->_viewDone[*(uint32_t*)(elem->_data)] = false;
+}
+
+// Append the response to the request 'req' with status 'status' and
+// payload 'payload' of 'size' bytes to the output of 'client'
+static void ELODaemonRespond(ELODaemonClient* const client,
+  const ELODaemonHeader* const req, const ELODaemonStatus status,
+  const void* const payload, const uint32_t size) {
+  ELODaemonHeader header = {
+    ._size = size, ._reqId = req->_reqId, ._type = req->_type,
+    ._status = status, ._reserved = 0};
+  ELODaemonReserve(&(client->_out), &(client->_outCap),
+    client->_outSize + sizeof(ELODaemonHeader) + size);
+  memcpy(client->_out + client->_outSize, &header,
+    sizeof(ELODaemonHeader));
+  client->_outSize += sizeof(ELODaemonHeader);
+  if (size > 0) {
+    memcpy(client->_out + client->_outSize, payload, size);
+    client->_outSize += size;
+  }
+}
+
+// Set 'entity' with the view of the entity 'id' in 'that'
+static void ELODaemonGetEntity(const ELODaemon* const that,
+  const uint32_t id, ELODaemonEntity* const entity) {
+  entity->_id = id;
+  if (id < that->_nbMax) {
+    entity->_rank = that->_viewRank[id];
+    entity->_elo = that->_viewELO[id];
+    entity->_softElo = that->_viewSoftELO[id];
+  } else {
+    entity->_rank = -1;
+    entity->_elo = ELORANK_STARTELO;
+    entity->_softElo = ELORANK_STARTELO;
+  }
+}
+
+// Answer the request 'req' of payload 'payload' from the client
+// 'client' of 'that'
+// 'isValid' is the result of ELODaemonCheckUpdate on the request if
+// it's an update, checked when the request has been parsed
+static void ELODaemonAnswer(const ELODaemon* const that,
+  ELODaemonClient* const client, const ELODaemonHeader* const req,
+  const char* const payload, const bool isValid) {
+  // The largest response is no more than 4 times the largest request
+  static ELODaemonEntity entities[ELODAEMON_MAXPAYLOAD / sizeof(uint32_t)];
+  if (req->_type == ELODaemonTypeUpdate) {
+    ELODaemonRespond(client, req,
+      (isValid ? ELODaemonStatusOK : ELODaemonStatusInvalidArg), NULL, 0);
+  } else if (req->_type == ELODaemonTypeGetEntity) {
+    if (req->_size % sizeof(uint32_t) != 0) {
+      ELODaemonRespond(client, req, ELODaemonStatusInvalidArg, NULL, 0);
+      return;
+    }
+    uint32_t nb = req->_size / sizeof(uint32_t);
+    for (uint32_t iId = 0; iId < nb; ++iId) {
+      uint32_t id;
+      memcpy(&id, payload + iId * sizeof(uint32_t), sizeof(uint32_t));
+      ELODaemonGetEntity(that, id, entities + iId);
+    }
+    ELODaemonRespond(client, req, ELODaemonStatusOK, entities,
+      nb * sizeof(ELODaemonEntity));
+  } else if (req->_type == ELODaemonTypeLeaderboard) {
+    if (req->_size != sizeof(ELODaemonRange)) {
+      ELODaemonRespond(client, req, ELODaemonStatusInvalidArg, NULL, 0);
+      return;
+    }
+    ELODaemonRange range;
+    memcpy(&range, payload, sizeof(ELODaemonRange));
+    uint32_t nb = 0;
+    if (range._first < that->_viewNb)
+      nb = MIN(range._nb, that->_viewNb - range._first);
+    nb = MIN(nb, sizeof(entities) / sizeof(ELODaemonEntity));
+    for (uint32_t iRank = 0; iRank < nb; ++iRank)
+      ELODaemonGetEntity(that,
+        that->_viewRanked[range._first + iRank], entities + iRank);
+    ELODaemonRespond(client, req, ELODaemonStatusOK, entities,
+      nb * sizeof(ELODaemonEntity));
+  } else if (req->_type == ELODaemonTypeGetNb) {
+    ELODaemonRespond(client, req, ELODaemonStatusOK, &(that->_viewNb),
+      sizeof(uint32_t));
+  } else {
+    ELODaemonRespond(client, req, ELODaemonStatusUnknownType, NULL, 0);
+  }
+}
+
+// Read the available bytes from the client 'client'
+static void ELODaemonRead(ELODaemonClient* const client) {
+  ELODaemonReserve(&(client->_in), &(client->_inCap),
+    client->_inSize + ELODAEMON_READSIZE);
+  ssize_t nb = read(client->_fd, client->_in + client->_inSize,
+    ELODAEMON_READSIZE);
+  if (nb > 0)
+    client->_inSize += nb;
+  else if (nb == 0 || (errno != EAGAIN && errno != EINTR))
+    ELODaemonCloseClient(client);
+}
+
+// Write the pending responses to the client 'client'
+static void ELODaemonWrite(ELODaemonClient* const client) {
+  while (client->_fd >= 0 && client->_outSent < client->_outSize) {
+    ssize_t nb = write(client->_fd, client->_out + client->_outSent,
+      client->_outSize - client->_outSent);
+    if (nb > 0) {
+      client->_outSent += nb;
+    } else if (nb < 0 && errno == EINTR) {
+      continue;
+    } else {
+      if (nb < 0 && errno != EAGAIN)
+        ELODaemonCloseClient(client);
+      break;
+    }
+  }
+  if (client->_outSent == client->_outSize) {
+    client->_outSent = 0;
+    client->_outSize = 0;
+  }
+}
+
+// Process the requests received by the clients of 'that' in one cycle
+// The updates of all the clients are queued and applied in one batch,
+// then all the requests are answered from the view of the ranking
+static void ELODaemonProcess(ELODaemon* const that) {
+  // Queue the updates
+  for (int iClient = 0; iClient < that->_nbClient; ++iClient) {
+    ELODaemonClient* client = that->_clients + iClient;
+    client->_parsed = 0;
+    client->_nbValid = 0;
+    if (client->_fd < 0)
+      continue;
+    ELODaemonHeader req;
+    const char* payload = NULL;
+    while (client->_inSize - client->_parsed >= sizeof(ELODaemonHeader)) {
+      // A header announcing a payload larger than allowed can't be from
+      // a valid client
+      memcpy(&req, client->_in + client->_parsed,
+        sizeof(ELODaemonHeader));
+      if (req._size > ELODAEMON_MAXPAYLOAD) {
+        ELODaemonCloseClient(client);
+        break;
+      }
+      if (ELODaemonGetMsg(client->_in, client->_inSize, client->_parsed,
+        &req, &payload) == false)
+        break;
+      if (req._type == ELODaemonTypeUpdate) {
+        bool isValid = ELODaemonCheckUpdate(that, payload, req._size);
+        if (isValid)
+          ELODaemonQueueUpdate(that, payload, req._size);
+        ELODaemonReserve(&(client->_valid), &(client->_capValid),
+          client->_nbValid + 1);
+        client->_valid[client->_nbValid++] = isValid;
+      }
+      client->_parsed += sizeof(ELODaemonHeader) + req._size;
+    }
+  }
+  // Apply the updates and update the view
+  if (that->_nbBatch > 0) {
+    for (int iRes = that->_nbBatch; iRes--;)
+      that->_batchPtr[iRes] = that->_batch + iRes;
+    ELORankUpdateBatch(that->_rank, that->_nbBatch, that->_batchPtr);
+    ELODaemonUpdateView(that);
+    for (int iRes = that->_nbBatch; iRes--;)
+      GSetFlush(that->_batch + iRes);
+    that->_nbBatch = 0;
+  }
+  // Answer the requests
+  for (int iClient = 0; iClient < that->_nbClient; ++iClient) {
+    ELODaemonClient* client = that->_clients + iClient;
+    if (client->_fd < 0 || client->_parsed == 0)
+      continue;
+    size_t offset = 0;
+    size_t iValid = 0;
+    ELODaemonHeader req;
+    const char* payload = NULL;
+    while (offset < client->_parsed) {
+      ELODaemonGetMsg(client->_in, client->_inSize, offset, &req,
+        &payload);
+      bool isValid = false;
+      if (req._type == ELODaemonTypeUpdate)
+        isValid = client->_valid[iValid++];
+      ELODaemonAnswer(that, client, &req, payload, isValid);
+      offset += sizeof(ELODaemonHeader) + req._size;
+    }
+    client->_inSize -= client->_parsed;
+    memmove(client->_in, client->_in + client->_parsed, client->_inSize);
+    ELODaemonWrite(client);
+  }
+}
+
+// Open the listening socket at 'path'
+// Return the socket or -1 in case of failure
+static int ELODaemonListen(const char* const path) {
+  struct sockaddr_un addr;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "socket path too long: %s\n", path);
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    perror("socket");
+    return -1;
+  }
+  unlink(path);
+  if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+    listen(fd, SOMAXCONN) < 0) {
+    perror(path);
+    close(fd);
+    return -1;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  return fd;
+}
+
+// Print the usage of the command
+void PrintUsage(void) {
+  printf("elorankd [-help] [-socket <path>] [-nbMax <n>] [-k <x>]\n");
+}
+
+int main(int argc, char** argv) {
+  // Default parameters
+  const char* path = ELODAEMON_SOCKET;
+  long nbMax = ELODAEMON_NBMAXENTITY;
+  float k = ELORANK_K;
+  // Decode the arguments
+  for (int iArg = 1; iArg < argc; ++iArg) {
+    if (strcmp(argv[iArg], "-help") == 0) {
+      PrintUsage();
+      return 0;
+    } else if (iArg + 1 >= argc) {
+      PrintUsage();
+      return 1;
+    } else if (strcmp(argv[iArg], "-socket") == 0) {
+      path = argv[++iArg];
+    } else if (strcmp(argv[iArg], "-nbMax") == 0) {
+      nbMax = atol(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-k") == 0) {
+      k = atof(argv[++iArg]);
+    } else {
+      PrintUsage();
+      return 1;
+    }
+  }
+  if (nbMax < 2 || nbMax > UINT32_MAX) {
+    PrintUsage();
+    return 1;
+  }
+  // Stop on SIGINT and SIGTERM, ignore the disconnections of clients
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = ELODaemonOnSignal;
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+  signal(SIGPIPE, SIG_IGN);
+  // Open the socket
+  int fdListen = ELODaemonListen(path);
+  if (fdListen < 0)
+    return 1;
+  ELODaemon* daemon = ELODaemonCreate((uint32_t)nbMax, k);
+  struct pollfd* fds = NULL;
+  int capFds = 0;
+  // Loop until stopped
+  while (flagStop == 0) {
+    // Wait for events on the listening socket and the clients
+    if (capFds < daemon->_nbClient + 1) {
+      capFds = 2 * (daemon->_nbClient + 1);
+      fds = ELODaemonRealloc(fds, sizeof(struct pollfd) * capFds);
+    }
+    fds[0].fd = fdListen;
+    fds[0].events = POLLIN;
+    for (int iClient = 0; iClient < daemon->_nbClient; ++iClient) {
+      ELODaemonClient* client = daemon->_clients + iClient;
+      fds[iClient + 1].fd = client->_fd;
+      fds[iClient + 1].events = 0;
+      // Stop reading the requests of a client which doesn't read the
+      // responses
+      if (client->_outSize - client->_outSent < ELODAEMON_MAXPENDING)
+        fds[iClient + 1].events |= POLLIN;
+      if (client->_outSent < client->_outSize)
+        fds[iClient + 1].events |= POLLOUT;
+    }
+    int nbFds = daemon->_nbClient + 1;
+    if (poll(fds, nbFds, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      perror("poll");
+      break;
+    }
+    // Read the requests and send the pending responses
+    for (int iClient = 0; iClient < nbFds - 1; ++iClient) {
+      ELODaemonClient* client = daemon->_clients + iClient;
+      if (fds[iClient + 1].revents & POLLOUT)
+        ELODaemonWrite(client);
+      if (fds[iClient + 1].revents & (POLLIN | POLLHUP | POLLERR))
+        ELODaemonRead(client);
+    }
+    // Process the requests
+    ELODaemonProcess(daemon);
+    ELODaemonPackClients(daemon);
+    // Accept the new clients
+    if (fds[0].revents & POLLIN) {
+      int fd;
+      while ((fd = accept(fdListen, NULL, NULL)) >= 0) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        ELODaemonAddClient(daemon, fd);
+      }
+    }
+  }
+  // Free memory
+  free(fds);
+  ELODaemonFree(&daemon);
+  close(fdListen);
+  unlink(path);
+  // Return success code
+  return 0;
+}
@@ -0,0 +1,112 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "elorank.h"
+#include "elorank-sim.h"
+#include "pberr.h"
+#include "pbmath.h"
+
+// Print the usage of the command
+void PrintUsage(void) {
+  printf("elosim [-help] [-nbEntity <n>] [-matchSize <n>] "
+    "[-nbMatch <n>] [-dist gauss|uniform] [-mean <x>] [-spread <x>] "
+    "[-noise <x>] [-k <x>] [-conv <x>] [-check <n>] [-nbSim <n>] "
+    "[-nbThread <n>] [-seed <n>]\n");
+}
+
+int main(int argc, char** argv) {
+  // Default parameters
+  ELOSimParam param = ELOSimParamCreateStatic();
+  int nbSim = 1;
+  int nbThread = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned long seed = 0;
+  // Decode the arguments
+  for (int iArg = 1; iArg < argc; ++iArg) {
+    if (strcmp(argv[iArg], "-help") == 0) {
+      PrintUsage();
+      return 0;
+    } else if (iArg + 1 >= argc) {
+      PrintUsage();
+      return 1;
+    } else if (strcmp(argv[iArg], "-nbEntity") == 0) {
+      param._nbEntity = atoi(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-matchSize") == 0) {
+      param._matchSize = atoi(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-nbMatch") == 0) {
+      param._nbMatch = atoi(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-dist") == 0) {
+      ++iArg;
+      if (strcmp(argv[iArg], "uniform") == 0)
+        param._skillDist = ELOSimSkillDistUniform;
+      else
+        param._skillDist = ELOSimSkillDistGauss;
+    } else if (strcmp(argv[iArg], "-mean") == 0) {
+      param._skillMean = atof(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-spread") == 0) {
+      param._skillSpread = atof(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-noise") == 0) {
+      param._perfSigma = atof(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-k") == 0) {
+      param._k = atof(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-conv") == 0) {
+      param._convergence = atof(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-check") == 0) {
+      param._nbCheck = atoi(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-nbSim") == 0) {
+      nbSim = atoi(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-nbThread") == 0) {
+      nbThread = atoi(argv[++iArg]);
+    } else if (strcmp(argv[iArg], "-seed") == 0) {
+      seed = strtoul(argv[++iArg], NULL, 10);
+    } else {
+      PrintUsage();
+      return 1;
+    }
+  }
+  if (nbSim < 1 || nbThread < 1 || param._nbEntity < 2 ||
+    param._matchSize < 2 || param._matchSize > param._nbEntity ||
+    param._nbCheck < 1) {
+    PrintUsage();
+    return 1;
+  }
+  // Run the simulations
+  ELOSimResult* results =
+    PBErrMalloc(ELORankErr, sizeof(ELOSimResult) * nbSim);
+  struct timeval start;
+  struct timeval stop;
+  gettimeofday(&start, NULL);
+  ELOSimRunBatch(&param, seed, nbSim, nbThread, results);
+  gettimeofday(&stop, NULL);
+  // Display the results
+  printf("seed convergence rankCorrelation eloError\n");
+  double sumConv = 0.0;
+  int nbConv = 0;
+  double sumCorr = 0.0;
+  double sumErr = 0.0;
+  for (int iSim = 0; iSim < nbSim; ++iSim) {
+    printf("%lu %d %f %f\n", results[iSim]._seed,
+      results[iSim]._convergence, results[iSim]._rankCorrelation,
+      results[iSim]._eloError);
+    if (results[iSim]._convergence >= 0) {
+      sumConv += results[iSim]._convergence;
+      ++nbConv;
+    }
+    sumCorr += results[iSim]._rankCorrelation;
+    sumErr += results[iSim]._eloError;
+  }
+  printf("converged: %d/%d\n", nbConv, nbSim);
+  if (nbConv > 0)
+    printf("mean convergence: %f\n", sumConv / (double)nbConv);
+  printf("mean rankCorrelation: %f\n", sumCorr / (double)nbSim);
+  printf("mean eloError: %f\n", sumErr / (double)nbSim);
+  printf("time: %fs (%d threads)\n",
+    (double)(stop.tv_sec - start.tv_sec) +
+    (double)(stop.tv_usec - start.tv_usec) / 1000000.0,
+    MIN(nbThread, nbSim));
+  // Free memory
+  free(results);
+  // Return success code
+  return 0;
+}
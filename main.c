@@ -6,6 +6,9 @@
 #include <unistd.h>
 #include <sys/time.h>
 #include "elorank.h"
+#include "elorank-sim.h"
+#include "elorank-map.h"
+#include "elorank-pool.h"
 #include "pberr.h"
 #include "pbmath.h"
 
@@ -162,11 +165,551 @@ void UnitTestUpdateGetRankGetElo() {
   printf("UnitTestUpdateGetRankGetElo OK\n");
 }
 
+void UnitTestUpdateBatch() {
+  srandom(RANDOMSEED);
+  ELORank* eloSeq = ELORankCreate();
+  ELORank* eloBatch = ELORankCreate();
+  Player *players[5] = {NULL};
+  for (int i = 5; i--;) {
+    players[i] = PBErrMalloc(ELORankErr, sizeof(Player));
+    players[i]->_id = i;
+    ELORankAdd(eloSeq, players[i]);
+    ELORankAdd(eloBatch, players[i]);
+  }
+  int nbRes = 20;
+  GSet res[20];
+  const GSet* resPtr[20];
+  for (int iRes = nbRes; iRes--;) {
+    res[iRes] = GSetCreateStatic();
+    resPtr[iRes] = res + iRes;
+    for (int i = 5; i--;)
+      if (i == iRes % 5 || rnd() < 0.5)
+        GSetAddSort(res + iRes, players[i], (float)i + rnd());
+    if (GSetNbElem(res + iRes) < 2)
+      GSetAddSort(res + iRes, players[(iRes + 1) % 5], 5.0);
+  }
+  for (int iRes = 0; iRes < nbRes; ++iRes)
+    ELORankUpdate(eloSeq, res + iRes);
+  ELORankUpdateBatch(eloBatch, nbRes, resPtr);
+  for (int i = 5; i--;) {
+    if (!ISEQUALF(ELORankGetELO(eloSeq, players[i]), 
+      ELORankGetELO(eloBatch, players[i])) ||
+      !ISEQUALF(ELORankGetSoftELO(eloSeq, players[i]), 
+      ELORankGetSoftELO(eloBatch, players[i])) ||
+      ELORankGetRank(eloSeq, players[i]) != 
+      ELORankGetRank(eloBatch, players[i])) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "ELORankUpdateBatch failed");
+      PBErrCatch(ELORankErr);
+    }
+  }
+  ELORankUpdateBatch(eloBatch, 0, NULL);
+  ELORankFree(&eloSeq);
+  ELORankFree(&eloBatch);
+  for (int iRes = nbRes; iRes--;)
+    GSetFlush(res + iRes);
+  for (int i = 5; i--;)
+    free(players[i]);
+  printf("UnitTestUpdateBatch OK\n");
+}
+
+void UnitTestDecay() {
+  ELORank* elo = ELORankCreate();
+  Player *players[3] = {NULL};
+  for (int i = 3; i--;) {
+    players[i] = PBErrMalloc(ELORankErr, sizeof(Player));
+    players[i]->_id = i;
+    ELORankAdd(elo, players[i]);
+  }
+  ELORankSetDecay(elo, 0.1);
+  if (!ISEQUALF(ELORankGetDecay(elo), 0.1)) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankSetDecay failed");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankSetELO(elo, players[0], 100.0);
+  ELORankSetTime(elo, 10);
+  if (ELORankGetTime(elo) != 10) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankSetTime failed");
+    PBErrCatch(ELORankErr);
+  }
+  if (!ISEQUALF(ELORankGetELO(elo, players[0]), 100.0 * exp(-1.0))) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankGetELO failed with decay");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankSetELO(elo, players[1], 50.0);
+  if (ELORankGetRank(elo, players[1]) != 0 || 
+    ELORankGetRank(elo, players[0]) != 1 ||
+    ELORankGetLastActivity(elo, players[0]) != 0 ||
+    ELORankGetLastActivity(elo, players[1]) != 10) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankGetRank failed with decay");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankSetIsMilestone(elo, players[0], true);
+  GSet res = GSetCreateStatic();
+  GSetAddSort(&res, players[1], 1.0);
+  GSetAddSort(&res, players[2], 0.0);
+  ELORankUpdate(elo, &res);
+  float eloB = ELORankGetELO(elo, players[1]);
+  float eloC = ELORankGetELO(elo, players[2]);
+  float expected = 50.0 + ELORANK_K * 
+    (1.0 - 1.0 / (1.0 + pow(10.0, (0.0 - 50.0) / 400.0)));
+  if (!ISEQUALF(eloB, expected) || eloC >= 0.0 ||
+    ELORankGetLastActivity(elo, players[2]) != 10) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankUpdate failed with decay");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankSetTime(elo, 15);
+  if (elo->_decayEpoch != 0 ||
+    !ISEQUALF(ELORankGetELO(elo, players[0]), 100.0 * exp(-1.0)) ||
+    ELORankGetRank(elo, players[0]) != 0 ||
+    ELORankGetRank(elo, players[1]) != 1) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankSetTime failed with milestone");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankSetTime(elo, 1000);
+  if (elo->_decayEpoch != 1000 ||
+    !ISEQUALF(ELORankGetELO(elo, players[0]), 100.0 * exp(-1.0)) ||
+    fabs(ELORankGetELO(elo, players[1])) > PBMATH_EPSILON ||
+    ELORankGetRank(elo, players[0]) != 0) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankSetTime failed");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankFree(&elo);
+  GSetFlush(&res);
+  for (int i = 3; i--;)
+    free(players[i]);
+  printf("UnitTestDecay OK\n");
+}
+
+void UnitTestFork() {
+  ELORank* elo = ELORankCreate();
+  Player *players[4] = {NULL};
+  for (int i = 4; i--;) {
+    players[i] = PBErrMalloc(ELORankErr, sizeof(Player));
+    players[i]->_id = i;
+    ELORankAdd(elo, players[i]);
+    ELORankSetELO(elo, players[i], 10.0 * (float)(4 - i));
+  }
+  ELORank* fork = ELORankFork(elo);
+  if (ELORankGetParent(fork) != elo || ELORankGetNb(fork) != 4 ||
+    GSetNbElem(&(fork->_set)) != 0) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankFork failed");
+    PBErrCatch(ELORankErr);
+  }
+  GSet res = GSetCreateStatic();
+  GSetAddSort(&res, players[3], 1.0);
+  GSetAddSort(&res, players[0], 0.0);
+  for (int iRun = 10; iRun--;)
+    ELORankUpdate(fork, &res);
+  if (GSetNbElem(&(fork->_set)) != 2 ||
+    !ISEQUALF(ELORankGetELO(elo, players[0]), 40.0) ||
+    !ISEQUALF(ELORankGetELO(elo, players[3]), 10.0) ||
+    ELORankGetELO(fork, players[3]) <= 
+    ELORankGetELO(fork, players[1]) ||
+    !ISEQUALF(ELORankGetELO(fork, players[1]), 30.0)) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankUpdate failed on fork");
+    PBErrCatch(ELORankErr);
+  }
+  if (ELORankGetRank(elo, players[3]) != 3 ||
+    ELORankGetRank(fork, players[3]) != 0 ||
+    ELORankGetRank(fork, players[0]) != 3 ||
+    ELORankGetRanked(fork, 1)->_data != players[1] ||
+    ELORankGetRanked(fork, 2)->_data != players[2]) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankGetRank failed on fork");
+    PBErrCatch(ELORankErr);
+  }
+  ELORank* forkFork = ELORankFork(fork);
+  ELORankSetELO(forkFork, players[2], 100.0);
+  if (ELORankGetRanked(forkFork, 0)->_data != players[2] ||
+    ELORankGetRanked(forkFork, 1)->_data != players[3] ||
+    ELORankGetRank(forkFork, players[0]) != 3 ||
+    ELORankGetRank(fork, players[2]) != 2 ||
+    !ISEQUALF(ELORankGetELO(elo, players[2]), 20.0)) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankFork failed on fork");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankFree(&forkFork);
+  ELORankFree(&fork);
+  ELORankFree(&elo);
+  GSetFlush(&res);
+  for (int i = 4; i--;)
+    free(players[i]);
+  printf("UnitTestFork OK\n");
+}
+
+void UnitTestHistory() {
+  srandom(RANDOMSEED);
+  ELORank* elo = ELORankCreate();
+  Player *players[3] = {NULL};
+  for (int i = 3; i--;) {
+    players[i] = PBErrMalloc(ELORankErr, sizeof(Player));
+    players[i]->_id = i;
+    ELORankAdd(elo, players[i]);
+  }
+  ELORankSetHistorySize(elo, players[0], 1000);
+  ELORankSetHistorySize(elo, players[1], ELORANK_HISTORYMINSIZE);
+  if (ELORankGetHistorySize(elo, players[0]) != 1000 ||
+    ELORankGetHistorySize(elo, players[2]) != 0) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankSetHistorySize failed");
+    PBErrCatch(ELORankErr);
+  }
+  int nbRun = 100;
+  float trueElos[100];
+  GSet res = GSetCreateStatic();
+  for (int iRun = 0; iRun < nbRun; ++iRun) {
+    GSetFlush(&res);
+    for (int i = 3; i--;)
+      GSetAddSort(&res, players[i], rnd());
+    ELORankUpdate(elo, &res);
+    trueElos[iRun] = ELORankGetELO(elo, players[0]);
+  }
+  if (ELORankGetNbMatch(elo) != nbRun ||
+    ELORankGetHistoryNb(elo, players[0]) != nbRun ||
+    ELORankGetHistoryNb(elo, players[2]) != 0) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankGetHistoryNb failed");
+    PBErrCatch(ELORankErr);
+  }
+  long matches[100];
+  float elos[100];
+  if (ELORankGetHistory(elo, players[0], nbRun, matches, elos) != nbRun) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankGetHistory failed");
+    PBErrCatch(ELORankErr);
+  }
+  for (int iRun = nbRun; iRun--;) {
+    if (matches[iRun] != iRun || 
+      fabs(elos[iRun] - trueElos[iRun]) > ELORANK_HISTORYRESOLUTION) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "ELORankGetHistory failed");
+      PBErrCatch(ELORankErr);
+    }
+  }
+  // The smallest history keeps only the most recent samples
+  int nb = ELORankGetHistoryNb(elo, players[1]);
+  if (nb < 2 || nb >= nbRun ||
+    ELORankGetHistory(elo, players[1], 2, matches, NULL) != 2 ||
+    matches[0] != nbRun - 2 || matches[1] != nbRun - 1) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankGetHistory failed when full");
+    PBErrCatch(ELORankErr);
+  }
+  // Shrinking the history keeps the most recent samples
+  ELORankSetHistorySize(elo, players[0], ELORANK_HISTORYMINSIZE);
+  nb = ELORankGetHistoryNb(elo, players[0]);
+  if (nb < 2 || nb >= nbRun ||
+    ELORankGetHistory(elo, players[0], 1, NULL, elos) != 1 ||
+    fabs(elos[0] - trueElos[nbRun - 1]) > ELORANK_HISTORYRESOLUTION) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankSetHistorySize failed");
+    PBErrCatch(ELORankErr);
+  }
+  // The history of a fork is independant of the one of its parent
+  ELORank* fork = ELORankFork(elo);
+  ELORankUpdate(fork, &res);
+  if (ELORankGetHistory(fork, players[0], 1, matches, NULL) != 1 ||
+    matches[0] != nbRun ||
+    ELORankGetHistory(elo, players[0], 1, matches, NULL) != 1 ||
+    matches[0] != nbRun - 1) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankGetHistory failed with fork");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankFree(&fork);
+  ELORankSetHistorySize(elo, players[0], 0);
+  if (ELORankGetHistoryNb(elo, players[0]) != 0) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankSetHistorySize failed");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankFree(&elo);
+  GSetFlush(&res);
+  for (int i = 3; i--;)
+    free(players[i]);
+  printf("UnitTestHistory OK\n");
+}
+
+void UnitTestGetExpectedScores() {
+  ELORank* elo = ELORankCreate();
+  Player *players[3] = {NULL};
+  for (int i = 3; i--;) {
+    players[i] = PBErrMalloc(ELORankErr, sizeof(Player));
+    players[i]->_id = i;
+    ELORankAdd(elo, players[i]);
+    ELORankSetELO(elo, players[i], 100.0 * (float)(2 - i));
+  }
+  const void* lobbies[5] = {players[0], players[1], players[2], 
+    players[2], players[0]};
+  int sizes[2] = {3, 2};
+  float mats[13];
+  float placements[5];
+  ELORankGetLobbiesExpectedScores(elo, 2, sizes, lobbies, mats, 
+    placements);
+  float sumPlacement = 0.0;
+  for (int i = 3; i--;) {
+    for (int j = 3; j--;) {
+      float a = 1.0 / (1.0 + pow(10.0, 
+        (ELORankGetELO(elo, players[j]) - 
+        ELORankGetELO(elo, players[i])) / 400.0));
+      if (!ISEQUALF(mats[i * 3 + j], a)) {
+        ELORankErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(ELORankErr->_msg, "ELORankGetExpectedScores failed");
+        PBErrCatch(ELORankErr);
+      }
+    }
+    sumPlacement += placements[i];
+  }
+  if (!ISEQUALF(sumPlacement, 3.0) || 
+    placements[0] >= placements[1] || placements[1] >= placements[2] ||
+    !ISEQUALF(mats[9 + 1], mats[2 * 3 + 0]) || 
+    !ISEQUALF(placements[3], 1.0 - mats[9 + 1])) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankGetExpectedScores failed");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankFree(&elo);
+  for (int i = 3; i--;)
+    free(players[i]);
+  printf("UnitTestGetExpectedScores OK\n");
+}
+
+void UnitTestMap() {
+  srandom(RANDOMSEED);
+  ELORankMap* map = 
+    ELORankMapCreate("./elorankmap.bin", 20, -200.0, 200.0, 1.0);
+  ELORank* elo = ELORankCreate();
+  if (map == NULL || ELORankMapGetNb(map) != 0 || 
+    ELORankMapGetCapacity(map) != 20 ||
+    !ISEQUALF(ELORankMapGetK(map), ELORANK_K)) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankMapCreate failed");
+    PBErrCatch(ELORankErr);
+  }
+  Player players[20];
+  for (int i = 20; i--;) {
+    players[i]._id = i;
+    ELORankAdd(elo, players + i);
+    if (!ELORankMapAdd(map, i)) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "ELORankMapAdd failed");
+      PBErrCatch(ELORankErr);
+    }
+  }
+  if (ELORankMapAdd(map, 0) || ELORankMapAdd(map, 20) ||
+    ELORankMapGetNb(map) != 20) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankMapAdd failed");
+    PBErrCatch(ELORankErr);
+  }
+  GSet res = GSetCreateStatic();
+  for (int iRun = 500; iRun--;) {
+    GSetFlush(&res);
+    while (GSetNbElem(&res) < 4) {
+      int i = (int)(rnd() * 19.99);
+      GSetElem* elem = res._head;
+      while (elem != NULL && elem->_data != players + i)
+        elem = elem->_next;
+      if (elem == NULL)
+        GSetAddSort(&res, players + i, (float)(int)(rnd() * 3.0));
+    }
+    unsigned long ids[4];
+    float scores[4];
+    GSetElem* elem = res._head;
+    for (int i = 0; i < 4; ++i) {
+      ids[i] = ((Player*)(elem->_data))->_id;
+      scores[i] = elem->_sortVal;
+      elem = elem->_next;
+    }
+    ELORankUpdate(elo, &res);
+    ELORankMapUpdate(map, 4, ids, scores);
+  }
+  ELORankMapSetIsMilestone(map, 3, true);
+  ELORankMapSetELO(map, 3, 150.0);
+  ELORankSetELO(elo, players + 3, 150.0);
+  for (int i = 20; i--;) {
+    if (!ISEQUALF(ELORankMapGetELO(map, i), 
+      ELORankGetELO(elo, players + i)) ||
+      !ISEQUALF(ELORankMapGetSoftELO(map, i), 
+      ELORankGetSoftELO(elo, players + i))) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "ELORankMapUpdate failed");
+      PBErrCatch(ELORankErr);
+    }
+  }
+  ELORankMapRemove(map, 7);
+  ELORankMapRemove(map, 19);
+  ELORankMapFree(&map);
+  map = ELORankMapOpen("./elorankmap.bin");
+  if (map == NULL || ELORankMapGetNb(map) != 18 || 
+    ELORankMapContains(map, 7) || !ELORankMapContains(map, 0)) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankMapOpen failed");
+    PBErrCatch(ELORankErr);
+  }
+  for (unsigned long rank = 0; rank < 18; ++rank) {
+    unsigned long id = ELORankMapGetRanked(map, rank);
+    if (ELORankMapGetRank(map, id) != rank || (rank > 0 && 
+      ELORankMapGetELO(map, id) > 
+      ELORankMapGetELO(map, ELORankMapGetRanked(map, rank - 1))) ||
+      !ISEQUALF(ELORankMapGetELO(map, id), 
+      ELORankGetELO(elo, players + id))) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "ELORankMapGetRanked failed");
+      PBErrCatch(ELORankErr);
+    }
+  }
+  if (ELORankMapGetRanked(map, 0) != 3) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankMapSetELO failed");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankMapFree(&map);
+  ELORankFree(&elo);
+  GSetFlush(&res);
+  remove("./elorankmap.bin");
+  printf("UnitTestMap OK\n");
+}
+
+void UnitTestPool() {
+  srandom(RANDOMSEED);
+  ELORankPool* pool = ELORankPoolCreate();
+  ELORank* elo = ELORankCreate();
+  int trackA = ELORankPoolAddTrack(pool, ELORANK_K);
+  Player players[20];
+  for (int i = 0; i < 20; ++i) {
+    players[i]._id = i;
+    ELORankAdd(elo, players + i);
+    if (ELORankPoolAdd(pool, players + i) != i) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "ELORankPoolAdd failed");
+      PBErrCatch(ELORankErr);
+    }
+  }
+  int trackB = ELORankPoolAddTrack(pool, 16.0);
+  if (ELORankPoolGetNb(pool) != 20 || ELORankPoolGetNbTrack(pool) != 2 ||
+    trackA != 0 || trackB != 1 || 
+    !ISEQUALF(ELORankPoolGetK(pool, trackB), 16.0) ||
+    ELORankPoolGetData(pool, 3) != players + 3) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankPoolAddTrack failed");
+    PBErrCatch(ELORankErr);
+  }
+  GSet res = GSetCreateStatic();
+  for (int iRun = 500; iRun--;) {
+    GSetFlush(&res);
+    while (GSetNbElem(&res) < 4) {
+      int i = (int)(rnd() * 19.99);
+      GSetElem* elem = res._head;
+      while (elem != NULL && elem->_data != players + i)
+        elem = elem->_next;
+      if (elem == NULL)
+        GSetAddSort(&res, players + i, (float)(int)(rnd() * 3.0));
+    }
+    int ids[4];
+    float scores[4];
+    GSetElem* elem = res._head;
+    for (int i = 0; i < 4; ++i) {
+      ids[i] = ((Player*)(elem->_data))->_id;
+      scores[i] = elem->_sortVal;
+      elem = elem->_next;
+    }
+    ELORankUpdate(elo, &res);
+    ELORankPoolUpdate(pool, trackA, 4, ids, scores);
+    for (int i = 0; i < 4; ++i)
+      scores[i] *= -1.0;
+    ELORankPoolUpdate(pool, trackB, 4, ids, scores);
+  }
+  for (int rank = 0; rank < 20; ++rank) {
+    int id = ELORankPoolGetRanked(pool, trackA, rank);
+    int ranks[2];
+    float elos[2];
+    ELORankPoolGetRanks(pool, id, ranks);
+    ELORankPoolGetELOs(pool, id, elos);
+    if (ranks[trackA] != rank || 
+      ranks[trackB] != ELORankPoolGetRank(pool, trackB, id) ||
+      !ISEQUALF(elos[trackB], ELORankPoolGetELO(pool, trackB, id)) ||
+      (rank > 0 && elos[trackA] > ELORankPoolGetELO(pool, trackA, 
+      ELORankPoolGetRanked(pool, trackA, rank - 1))) ||
+      !ISEQUALF(elos[trackA], ELORankGetELO(elo, players + id)) ||
+      !ISEQUALF(ELORankPoolGetSoftELO(pool, trackA, id), 
+      ELORankGetSoftELO(elo, players + id))) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "ELORankPoolUpdate failed");
+      PBErrCatch(ELORankErr);
+    }
+  }
+  int last = ELORankPoolGetRanked(pool, trackB, 19);
+  ELORankPoolSetIsMilestone(pool, trackB, last, true);
+  ELORankPoolSetELO(pool, trackB, last, 1000.0);
+  int ids[2] = {last, ELORankPoolGetRanked(pool, trackB, 1)};
+  float scores[2] = {0.0, 1.0};
+  ELORankPoolUpdate(pool, trackB, 2, ids, scores);
+  if (ELORankPoolGetRank(pool, trackB, last) != 0 ||
+    !ISEQUALF(ELORankPoolGetELO(pool, trackB, last), 1000.0)) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELORankPoolSetELO failed");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankPoolFree(&pool);
+  ELORankFree(&elo);
+  GSetFlush(&res);
+  printf("UnitTestPool OK\n");
+}
+
+void UnitTestSim() {
+  ELOSimParam param = ELOSimParamCreateStatic();
+  param._nbEntity = 10;
+  param._matchSize = 3;
+  param._nbMatch = 2000;
+  param._nbCheck = 10;
+  ELOSimResult results[4];
+  ELOSimRunBatch(&param, RANDOMSEED, 4, 2, results);
+  ELOSimResult result;
+  ELOSimRun(&param, RANDOMSEED + 2, &result);
+  if (result._seed != results[2]._seed ||
+    result._convergence != results[2]._convergence ||
+    !ISEQUALF(result._rankCorrelation, results[2]._rankCorrelation) ||
+    !ISEQUALF(result._eloError, results[2]._eloError)) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELOSimRunBatch failed");
+    PBErrCatch(ELORankErr);
+  }
+  for (int iSim = 4; iSim--;) {
+    if (results[iSim]._rankCorrelation < 0.5 ||
+      results[iSim]._convergence < 0) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "ELOSimRun failed");
+      PBErrCatch(ELORankErr);
+    }
+  }
+  printf("UnitTestSim OK\n");
+}
+
 void UnitTestAll() {
   UnitTestCreateFree();
   UnitTestSetGetK();
   UnitTestAddRemoveGetNb();
   UnitTestUpdateGetRankGetElo();
+  UnitTestUpdateBatch();
+  UnitTestDecay();
+  UnitTestFork();
+  UnitTestHistory();
+  UnitTestGetExpectedScores();
+  UnitTestMap();
+  UnitTestPool();
+  UnitTestSim();
   printf("UnitTestAll OK\n");
 }
 
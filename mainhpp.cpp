@@ -0,0 +1,475 @@
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "elorank.h"
+#include "pberr.h"
+#include "pbmath.h"
+}
+#include "elorank.hpp"
+
+#define RANDOMSEED 2
+
+typedef struct Player {
+  int _id;
+} Player;
+
+// Set 'ids' and 'scores' with a random match between 'nb' different
+// entities among the 'nbEntity' entities 'entities'
+void RandomMatch(const int nbEntity, const int* const entities,
+  const int nb, int* const ids, float* const scores) {
+  for (int i = 0; i < nb; ++i) {
+    bool isNew = false;
+    while (!isNew) {
+      ids[i] = entities[random() % nbEntity];
+      isNew = true;
+      for (int j = 0; j < i; ++j)
+        if (ids[j] == ids[i])
+          isNew = false;
+    }
+    scores[i] = (float)(random() % 5);
+  }
+}
+
+// Apply the result of the match between the 'nb' entities 'ids' of
+// scores 'scores' to 'elo' with ELORankUpdate
+void UpdateC(ELORank* const elo, Player* const players, const int nb,
+  const int* const ids, const float* const scores) {
+  GSet res = GSetCreateStatic();
+  for (int i = 0; i < nb; ++i)
+    GSetAddSort(&res, players + ids[i], scores[i]);
+  ELORankUpdate(elo, &res);
+  GSetFlush(&res);
+}
+
+// Check the entities of 'eloHpp' against the ones of 'elo': same
+// number of entities, ELO differing by at most 'tolerance' (0.0 for
+// exactly equal) for each entity and at each rank, ranks consistent
+// with the ELO in 'eloHpp', and if 'checkSoft' is true same soft ELO
+// and number of evaluation
+// Entities of equal ELO may be ranked in a different order
+template <typename Ranking>
+void CheckCompareC(const ELORank* const elo, const Ranking& eloHpp,
+  const char* const label, const double tolerance, const bool checkSoft) {
+  if (eloHpp.GetNb() != (std::size_t)ELORankGetNb(elo)) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "%s: ELORankTpl::GetNb failed", label);
+    PBErrCatch(ELORankErr);
+  }
+  for (int rank = 0; rank < ELORankGetNb(elo); ++rank) {
+    const ELOEntity* entity = ELORankGetRanked(elo, rank);
+    int id = ((const Player*)(entity->_data))->_id;
+    double eloC = ELORankGetELO(elo, entity->_data);
+    int idHpp = eloHpp.GetRanked(rank);
+    if (std::fabs(eloC - (double)eloHpp.GetELO(idHpp)) > tolerance ||
+      eloHpp.GetRank(idHpp) != (std::size_t)rank ||
+      (rank > 0 &&
+      eloHpp.GetELO(eloHpp.GetRanked(rank - 1)) < eloHpp.GetELO(idHpp))) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "%s: ELORankTpl::GetRanked failed (%d)",
+        label, rank);
+      PBErrCatch(ELORankErr);
+    }
+    if (std::fabs(eloC - (double)eloHpp.GetELO(id)) > tolerance) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "%s: ELORankTpl::GetELO failed (%d)",
+        label, id);
+      PBErrCatch(ELORankErr);
+    }
+    if (checkSoft && (std::fabs(ELORankGetSoftELO(elo, entity->_data) -
+      (double)eloHpp.GetSoftELO(id)) > tolerance ||
+      entity->_nbRun != eloHpp.GetNbRun(id))) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "%s: ELORankTpl::GetSoftELO failed (%d)",
+        label, id);
+      PBErrCatch(ELORankErr);
+    }
+  }
+}
+
+// Check that random matches give the same ELO, soft ELO and rank with
+// ELORankUpdate and ELORankTpl (float ELO, constant K, milestones)
+// Matches of 2 to 12 entities use both the fixed size and dynamic
+// implementations of ELORankTpl
+void UnitTestCompareC() {
+  srandom(RANDOMSEED);
+  const int nbPlayer = 50;
+  ELORank* elo = ELORankCreate();
+  ELORankTpl<int> eloHpp;
+  Player players[nbPlayer];
+  int entities[nbPlayer];
+  for (int i = 0; i < nbPlayer; ++i) {
+    players[i]._id = i;
+    entities[i] = i;
+    ELORankAdd(elo, players + i);
+    eloHpp.Add(i);
+  }
+  ELORankSetIsMilestone(elo, players + 7, true);
+  eloHpp.SetIsMilestone(7, true);
+  for (int iRun = 3000; iRun--;) {
+    int nb = 2 + random() % 11;
+    int ids[12];
+    float scores[12];
+    RandomMatch(nbPlayer, entities, nb, ids, scores);
+    UpdateC(elo, players, nb, ids, scores);
+    eloHpp.Update(nb, ids, scores);
+  }
+  CheckCompareC(elo, eloHpp, "UnitTestCompareC", 0.0, true);
+  ELORankFree(&elo);
+  printf("UnitTestCompareC OK\n");
+}
+
+// Check the calculation of the variation of ELO for arrays of size 'N'
+// known at compile time against the one for arrays of any size and
+// ELORankAddDeltaELO
+template <std::size_t N>
+void CheckDeltaFixed() {
+  for (int iRun = 100; iRun--;) {
+    std::array<float, N> k;
+    std::array<float, N> elos;
+    std::array<float, N> scores;
+    std::array<float, N> deltas;
+    float deltasDyn[N];
+    float deltasC[N];
+    for (std::size_t i = 0; i < N; ++i) {
+      k[i] = ELORANK_K;
+      elos[i] = (float)(random() % 400) - 200.0;
+      scores[i] = (float)(random() % 3);
+      deltas[i] = 0.0;
+      deltasDyn[i] = 0.0;
+      deltasC[i] = 0.0;
+    }
+    ELOAddDeltaELO(k, elos, scores, deltas);
+    ELOAddDeltaELO(N, k.data(), elos.data(), scores.data(), deltasDyn);
+    ELORankAddDeltaELO(ELORANK_K, N, elos.data(), scores.data(), deltasC);
+    for (std::size_t i = 0; i < N; ++i) {
+      if (deltas[i] != deltasDyn[i] || deltas[i] != deltasC[i]) {
+        ELORankErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(ELORankErr->_msg, "ELOAddDeltaELO failed (%zu)", N);
+        PBErrCatch(ELORankErr);
+      }
+    }
+  }
+}
+
+// Check each size of match, from 2 to 12 entities, against
+// ELORankUpdate, i.e. each fixed size implementation (2 to 8) and the
+// dynamic one (9 and more)
+void UnitTestCompareCMatchSize() {
+  srandom(RANDOMSEED);
+  CheckDeltaFixed<2>();
+  CheckDeltaFixed<3>();
+  CheckDeltaFixed<4>();
+  CheckDeltaFixed<5>();
+  CheckDeltaFixed<6>();
+  CheckDeltaFixed<7>();
+  CheckDeltaFixed<8>();
+  const int nbPlayer = 20;
+  Player players[nbPlayer];
+  int entities[nbPlayer];
+  for (int i = 0; i < nbPlayer; ++i) {
+    players[i]._id = i;
+    entities[i] = i;
+  }
+  for (int nb = 2; nb <= 12; ++nb) {
+    ELORank* elo = ELORankCreate();
+    ELORankTpl<int> eloHpp;
+    for (int i = 0; i < nbPlayer; ++i) {
+      ELORankAdd(elo, players + i);
+      eloHpp.Add(i);
+    }
+    for (int iRun = 300; iRun--;) {
+      int ids[12];
+      float scores[12];
+      RandomMatch(nbPlayer, entities, nb, ids, scores);
+      UpdateC(elo, players, nb, ids, scores);
+      eloHpp.Update(nb, ids, scores);
+    }
+    CheckCompareC(elo, eloHpp, "UnitTestCompareCMatchSize", 0.0, true);
+    ELORankFree(&elo);
+  }
+  printf("UnitTestCompareCMatchSize OK\n");
+}
+
+// Apply the result of the match between the 'N' entities 'ids' of
+// scores 'scores' to 'eloHpp' as an ELOResult
+template <std::size_t N>
+void UpdateResult(ELORankTpl<int>& eloHpp, const int* const ids,
+  const float* const scores) {
+  ELOResult<int, float, N> res;
+  for (std::size_t i = 0; i < N; ++i) {
+    res._ids[i] = ids[i];
+    res._scores[i] = scores[i];
+  }
+  eloHpp.Update(res);
+}
+
+// Check the update with an ELOResult against ELORankUpdate
+void UnitTestCompareCResult() {
+  srandom(RANDOMSEED);
+  const int nbPlayer = 20;
+  ELORank* elo = ELORankCreate();
+  ELORankTpl<int> eloHpp;
+  Player players[nbPlayer];
+  int entities[nbPlayer];
+  for (int i = 0; i < nbPlayer; ++i) {
+    players[i]._id = i;
+    entities[i] = i;
+    ELORankAdd(elo, players + i);
+    eloHpp.Add(i);
+  }
+  for (int iRun = 900; iRun--;) {
+    int nb = 2 + iRun % 3 * 3;
+    int ids[8];
+    float scores[8];
+    RandomMatch(nbPlayer, entities, nb, ids, scores);
+    UpdateC(elo, players, nb, ids, scores);
+    if (nb == 2)
+      UpdateResult<2>(eloHpp, ids, scores);
+    else if (nb == 5)
+      UpdateResult<5>(eloHpp, ids, scores);
+    else
+      UpdateResult<8>(eloHpp, ids, scores);
+  }
+  CheckCompareC(elo, eloHpp, "UnitTestCompareCResult", 0.0, true);
+  ELORankFree(&elo);
+  printf("UnitTestCompareCResult OK\n");
+}
+
+// Check SetELO (also with the id given as a reference in the ranking),
+// ResetELO, Remove and Add mixed with random matches against the C
+// implementation
+void UnitTestCompareCSetResetRemove() {
+  srandom(RANDOMSEED);
+  const int nbMaxPlayer = 200;
+  ELORank* elo = ELORankCreate();
+  ELORankTpl<int> eloHpp;
+  Player players[nbMaxPlayer];
+  std::vector<int> entities;
+  int nbPlayer = 0;
+  for (; nbPlayer < 40; ++nbPlayer) {
+    players[nbPlayer]._id = nbPlayer;
+    entities.push_back(nbPlayer);
+    ELORankAdd(elo, players + nbPlayer);
+    eloHpp.Add(nbPlayer);
+  }
+  for (int iRun = 0; iRun < 3000; ++iRun) {
+    int op = random() % 10;
+    int id = entities[random() % entities.size()];
+    float val = 20.0 * (float)(random() % 3 - 1);
+    if (op == 0) {
+      ELORankSetELO(elo, players + id, val);
+      eloHpp.SetELO(id, val);
+    } else if (op == 1) {
+      int rank = random() % eloHpp.GetNb();
+      ELORankSetELO(elo, players + eloHpp.GetRanked(rank), val);
+      eloHpp.SetELO(eloHpp.GetRanked(rank), val);
+    } else if (op == 2) {
+      ELORankResetELO(elo, players + id);
+      eloHpp.ResetELO(id);
+    } else if (op == 3 && nbPlayer < nbMaxPlayer) {
+      ELORankRemove(elo, players + id);
+      eloHpp.Remove(id);
+      for (std::size_t i = 0; i < entities.size(); ++i)
+        if (entities[i] == id)
+          entities[i] = nbPlayer;
+      players[nbPlayer]._id = nbPlayer;
+      ELORankAdd(elo, players + nbPlayer);
+      eloHpp.Add(nbPlayer);
+      ++nbPlayer;
+    } else {
+      int nb = 2 + random() % 5;
+      int ids[6];
+      float scores[6];
+      RandomMatch(entities.size(), entities.data(), nb, ids, scores);
+      UpdateC(elo, players, nb, ids, scores);
+      eloHpp.Update(nb, ids, scores);
+    }
+    if (iRun % 100 == 0)
+      CheckCompareC(elo, eloHpp, "UnitTestCompareCSetResetRemove", 0.0,
+        true);
+  }
+  CheckCompareC(elo, eloHpp, "UnitTestCompareCSetResetRemove", 0.0, true);
+  ELORankFree(&elo);
+  printf("UnitTestCompareCSetResetRemove OK\n");
+}
+
+// Check the ranks when the entities are split in a few long runs of
+// equal ELO, the entities being moved across the runs by SetELO,
+// matches and removal
+void UnitTestCompareCEqualELO() {
+  srandom(RANDOMSEED);
+  const int nbPlayer = 300;
+  ELORank* elo = ELORankCreate();
+  ELORankTpl<int> eloHpp;
+  Player players[nbPlayer];
+  std::vector<int> entities;
+  for (int i = 0; i < nbPlayer; ++i) {
+    players[i]._id = i;
+    entities.push_back(i);
+    ELORankAdd(elo, players + i);
+    eloHpp.Add(i);
+    float val = 10.0 * (float)(i % 4);
+    ELORankSetELO(elo, players + i, val);
+    eloHpp.SetELO(i, val);
+  }
+  CheckCompareC(elo, eloHpp, "UnitTestCompareCEqualELO", 0.0, true);
+  for (int iRun = 0; iRun < 1000; ++iRun) {
+    int op = random() % 4;
+    if (op == 0) {
+      int rank = random() % eloHpp.GetNb();
+      float val = 10.0 * (float)(random() % 4);
+      ELORankSetELO(elo, players + eloHpp.GetRanked(rank), val);
+      eloHpp.SetELO(eloHpp.GetRanked(rank), val);
+    } else if (op == 1 && entities.size() > 100) {
+      std::size_t i = random() % entities.size();
+      ELORankRemove(elo, players + entities[i]);
+      eloHpp.Remove(entities[i]);
+      entities.erase(entities.begin() + i);
+    } else {
+      int ids[2];
+      float scores[2];
+      RandomMatch(entities.size(), entities.data(), 2, ids, scores);
+      UpdateC(elo, players, 2, ids, scores);
+      eloHpp.Update(2, ids, scores);
+    }
+    if (iRun % 50 == 0)
+      CheckCompareC(elo, eloHpp, "UnitTestCompareCEqualELO", 0.0, true);
+  }
+  CheckCompareC(elo, eloHpp, "UnitTestCompareCEqualELO", 0.0, true);
+  ELORankFree(&elo);
+  printf("UnitTestCompareCEqualELO OK\n");
+}
+
+// Check the policies ELOKFixed and ELOMilestoneNone against
+// ELORankUpdate with the same K, and ELOKProvisional against the
+// variations of ELO given by ELORankAddDeltaELO with the K of each
+// entity
+void UnitTestCompareCPolicy() {
+  srandom(RANDOMSEED);
+  const int nbPlayer = 30;
+  Player players[nbPlayer];
+  int entities[nbPlayer];
+  ELORank* elo = ELORankCreate();
+  ELORankSetK(elo, 16.0);
+  ELORankTpl<int, float, ELOKFixed<16>, ELOMilestoneNone> eloFixed;
+  for (int i = 0; i < nbPlayer; ++i) {
+    players[i]._id = i;
+    entities[i] = i;
+    ELORankAdd(elo, players + i);
+    eloFixed.Add(i);
+  }
+  for (int iRun = 1000; iRun--;) {
+    int nb = 2 + random() % 11;
+    int ids[12];
+    float scores[12];
+    RandomMatch(nbPlayer, entities, nb, ids, scores);
+    UpdateC(elo, players, nb, ids, scores);
+    eloFixed.Update(nb, ids, scores);
+  }
+  CheckCompareC(elo, eloFixed, "UnitTestCompareCPolicy", 0.0, true);
+  if (eloFixed.GetIsMilestone(0)) {
+    ELORankErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(ELORankErr->_msg, "ELOMilestoneNone failed");
+    PBErrCatch(ELORankErr);
+  }
+  ELORankFree(&elo);
+  // The ELO of the C ranking is set to the one calculated with
+  // ELORankAddDeltaELO, the participants being in the order of the
+  // result set as in ELORankUpdate
+  elo = ELORankCreate();
+  ELORankTpl<int, float, ELOKProvisional<32, 8, 10>> eloProv;
+  long nbRun[nbPlayer];
+  for (int i = 0; i < nbPlayer; ++i) {
+    ELORankAdd(elo, players + i);
+    eloProv.Add(i);
+    nbRun[i] = 0;
+  }
+  for (int iRun = 1000; iRun--;) {
+    int nb = 2 + random() % 11;
+    int ids[12];
+    float scores[12];
+    RandomMatch(nbPlayer, entities, nb, ids, scores);
+    GSet res = GSetCreateStatic();
+    for (int i = 0; i < nb; ++i)
+      GSetAddSort(&res, players + ids[i], scores[i]);
+    int sortedIds[12];
+    float elos[12];
+    float sortedScores[12];
+    int iElem = 0;
+    for (GSetElem* elem = res._head; elem != NULL; elem = elem->_next) {
+      sortedIds[iElem] = ((Player*)(elem->_data))->_id;
+      elos[iElem] = ELORankGetELO(elo, elem->_data);
+      sortedScores[iElem] = elem->_sortVal;
+      ++iElem;
+    }
+    GSetFlush(&res);
+    for (int i = 0; i < nb; ++i) {
+      float deltas[12] = {0.0};
+      float k = (nbRun[sortedIds[i]] < 10 ? 32.0 : 8.0);
+      ELORankAddDeltaELO(k, nb, elos, sortedScores, deltas);
+      ELORankSetELO(elo, players + sortedIds[i], elos[i] + deltas[i]);
+      ++(nbRun[sortedIds[i]]);
+    }
+    eloProv.Update(nb, ids, scores);
+  }
+  CheckCompareC(elo, eloProv, "UnitTestCompareCPolicy", 0.0, false);
+  for (int i = 0; i < nbPlayer; ++i) {
+    if (eloProv.GetNbRun(i) != nbRun[i]) {
+      ELORankErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(ELORankErr->_msg, "ELOKProvisional failed (%d)", i);
+      PBErrCatch(ELORankErr);
+    }
+  }
+  ELORankFree(&elo);
+  printf("UnitTestCompareCPolicy OK\n");
+}
+
+// Check the ranking with double ELO against ELORankUpdate, the ELO
+// differing only by the rounding of float
+void UnitTestCompareCDouble() {
+  srandom(RANDOMSEED);
+  const int nbPlayer = 30;
+  ELORank* elo = ELORankCreate();
+  ELORankTpl<int, double> eloHpp;
+  Player players[nbPlayer];
+  int entities[nbPlayer];
+  for (int i = 0; i < nbPlayer; ++i) {
+    players[i]._id = i;
+    entities[i] = i;
+    ELORankAdd(elo, players + i);
+    eloHpp.Add(i);
+  }
+  for (int iRun = 500; iRun--;) {
+    int nb = 2 + random() % 11;
+    int ids[12];
+    float scores[12];
+    double scoresHpp[12];
+    RandomMatch(nbPlayer, entities, nb, ids, scores);
+    for (int i = 0; i < nb; ++i)
+      scoresHpp[i] = scores[i];
+    UpdateC(elo, players, nb, ids, scores);
+    eloHpp.Update(nb, ids, scoresHpp);
+  }
+  CheckCompareC(elo, eloHpp, "UnitTestCompareCDouble", 0.01, true);
+  ELORankFree(&elo);
+  printf("UnitTestCompareCDouble OK\n");
+}
+
+void UnitTestAll() {
+  UnitTestCompareC();
+  UnitTestCompareCMatchSize();
+  UnitTestCompareCResult();
+  UnitTestCompareCSetResetRemove();
+  UnitTestCompareCEqualELO();
+  UnitTestCompareCPolicy();
+  UnitTestCompareCDouble();
+  printf("UnitTestAll OK\n");
+}
+
+int main() {
+  UnitTestAll();
+  // Return success code
+  return 0;
+}